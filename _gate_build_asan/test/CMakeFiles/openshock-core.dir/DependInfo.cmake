@@ -0,0 +1,26 @@
+
+# Consider dependencies only in project.
+set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
+
+# The set of languages for which implicit dependencies are needed:
+set(CMAKE_DEPENDS_LANGUAGES
+  )
+
+# The set of dependency files which are needed:
+set(CMAKE_DEPENDS_DEPENDENCY_FILES
+  "/root/repo/src/EventArena.cpp" "test/CMakeFiles/openshock-core.dir/__/src/EventArena.cpp.o" "gcc" "test/CMakeFiles/openshock-core.dir/__/src/EventArena.cpp.o.d"
+  "/root/repo/src/Executor.cpp" "test/CMakeFiles/openshock-core.dir/__/src/Executor.cpp.o" "gcc" "test/CMakeFiles/openshock-core.dir/__/src/Executor.cpp.o.d"
+  "/root/repo/src/FileService.cpp" "test/CMakeFiles/openshock-core.dir/__/src/FileService.cpp.o" "gcc" "test/CMakeFiles/openshock-core.dir/__/src/FileService.cpp.o.d"
+  "/root/repo/src/LevelStats.cpp" "test/CMakeFiles/openshock-core.dir/__/src/LevelStats.cpp.o" "gcc" "test/CMakeFiles/openshock-core.dir/__/src/LevelStats.cpp.o.d"
+  "/root/repo/src/ShockConfig.cpp" "test/CMakeFiles/openshock-core.dir/__/src/ShockConfig.cpp.o" "gcc" "test/CMakeFiles/openshock-core.dir/__/src/ShockConfig.cpp.o.d"
+  "/root/repo/src/ShockDispatch.cpp" "test/CMakeFiles/openshock-core.dir/__/src/ShockDispatch.cpp.o" "gcc" "test/CMakeFiles/openshock-core.dir/__/src/ShockDispatch.cpp.o.d"
+  "/root/repo/src/ShockResponse.cpp" "test/CMakeFiles/openshock-core.dir/__/src/ShockResponse.cpp.o" "gcc" "test/CMakeFiles/openshock-core.dir/__/src/ShockResponse.cpp.o.d"
+  "/root/repo/test/shim/MainThread.cpp" "test/CMakeFiles/openshock-core.dir/shim/MainThread.cpp.o" "gcc" "test/CMakeFiles/openshock-core.dir/shim/MainThread.cpp.o.d"
+  )
+
+# Targets to which this target links.
+set(CMAKE_TARGET_LINKED_INFO_FILES
+  )
+
+# Fortran module output directory.
+set(CMAKE_Fortran_TARGET_MODULE_DIR "")
@@ -0,0 +1,25 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/openshock-core.dir/__/src/EventArena.cpp.o"
+  "CMakeFiles/openshock-core.dir/__/src/EventArena.cpp.o.d"
+  "CMakeFiles/openshock-core.dir/__/src/Executor.cpp.o"
+  "CMakeFiles/openshock-core.dir/__/src/Executor.cpp.o.d"
+  "CMakeFiles/openshock-core.dir/__/src/FileService.cpp.o"
+  "CMakeFiles/openshock-core.dir/__/src/FileService.cpp.o.d"
+  "CMakeFiles/openshock-core.dir/__/src/LevelStats.cpp.o"
+  "CMakeFiles/openshock-core.dir/__/src/LevelStats.cpp.o.d"
+  "CMakeFiles/openshock-core.dir/__/src/ShockConfig.cpp.o"
+  "CMakeFiles/openshock-core.dir/__/src/ShockConfig.cpp.o.d"
+  "CMakeFiles/openshock-core.dir/__/src/ShockDispatch.cpp.o"
+  "CMakeFiles/openshock-core.dir/__/src/ShockDispatch.cpp.o.d"
+  "CMakeFiles/openshock-core.dir/__/src/ShockResponse.cpp.o"
+  "CMakeFiles/openshock-core.dir/__/src/ShockResponse.cpp.o.d"
+  "CMakeFiles/openshock-core.dir/shim/MainThread.cpp.o"
+  "CMakeFiles/openshock-core.dir/shim/MainThread.cpp.o.d"
+  "libopenshock-core.a"
+  "libopenshock-core.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/openshock-core.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
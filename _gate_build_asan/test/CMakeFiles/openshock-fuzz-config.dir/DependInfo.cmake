@@ -0,0 +1,21 @@
+
+# Consider dependencies only in project.
+set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
+
+# The set of languages for which implicit dependencies are needed:
+set(CMAKE_DEPENDS_LANGUAGES
+  )
+
+# The set of dependency files which are needed:
+set(CMAKE_DEPENDS_DEPENDENCY_FILES
+  "/root/repo/test/fuzz/FuzzConfig.cpp" "test/CMakeFiles/openshock-fuzz-config.dir/fuzz/FuzzConfig.cpp.o" "gcc" "test/CMakeFiles/openshock-fuzz-config.dir/fuzz/FuzzConfig.cpp.o.d"
+  "/root/repo/test/fuzz/FuzzDriver.cpp" "test/CMakeFiles/openshock-fuzz-config.dir/fuzz/FuzzDriver.cpp.o" "gcc" "test/CMakeFiles/openshock-fuzz-config.dir/fuzz/FuzzDriver.cpp.o.d"
+  )
+
+# Targets to which this target links.
+set(CMAKE_TARGET_LINKED_INFO_FILES
+  "/root/repo/_gate_build_asan/test/CMakeFiles/openshock-core.dir/DependInfo.cmake"
+  )
+
+# Fortran module output directory.
+set(CMAKE_Fortran_TARGET_MODULE_DIR "")
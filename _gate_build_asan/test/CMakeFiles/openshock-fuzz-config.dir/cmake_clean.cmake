@@ -0,0 +1,13 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/openshock-fuzz-config.dir/fuzz/FuzzConfig.cpp.o"
+  "CMakeFiles/openshock-fuzz-config.dir/fuzz/FuzzConfig.cpp.o.d"
+  "CMakeFiles/openshock-fuzz-config.dir/fuzz/FuzzDriver.cpp.o"
+  "CMakeFiles/openshock-fuzz-config.dir/fuzz/FuzzDriver.cpp.o.d"
+  "openshock-fuzz-config"
+  "openshock-fuzz-config.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/openshock-fuzz-config.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
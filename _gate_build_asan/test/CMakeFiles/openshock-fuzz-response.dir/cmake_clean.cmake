@@ -0,0 +1,13 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/openshock-fuzz-response.dir/fuzz/FuzzDriver.cpp.o"
+  "CMakeFiles/openshock-fuzz-response.dir/fuzz/FuzzDriver.cpp.o.d"
+  "CMakeFiles/openshock-fuzz-response.dir/fuzz/FuzzResponse.cpp.o"
+  "CMakeFiles/openshock-fuzz-response.dir/fuzz/FuzzResponse.cpp.o.d"
+  "openshock-fuzz-response"
+  "openshock-fuzz-response.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/openshock-fuzz-response.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
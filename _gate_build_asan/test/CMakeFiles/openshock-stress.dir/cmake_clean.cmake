@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/openshock-stress.dir/StressTest.cpp.o"
+  "CMakeFiles/openshock-stress.dir/StressTest.cpp.o.d"
+  "openshock-stress"
+  "openshock-stress.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/openshock-stress.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
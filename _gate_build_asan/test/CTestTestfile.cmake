@@ -0,0 +1,12 @@
+# CMake generated Testfile for 
+# Source directory: /root/repo/test
+# Build directory: /root/repo/_gate_build_asan/test
+# 
+# This file includes the relevant testing commands required for 
+# testing this directory and lists subdirectories to be tested as well.
+add_test([=[stress]=] "/root/repo/_gate_build_asan/test/openshock-stress" "5")
+set_tests_properties([=[stress]=] PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/test/CMakeLists.txt;35;add_test;/root/repo/test/CMakeLists.txt;0;")
+add_test([=[openshock-fuzz-config]=] "/root/repo/_gate_build_asan/test/openshock-fuzz-config" "-rss_limit_mb=256" "-timeout=2" "-runs=20000" "/root/repo/_gate_build_asan/test/openshock-fuzz-config-corpus" "/root/repo/test/fuzz/corpus/config")
+set_tests_properties([=[openshock-fuzz-config]=] PROPERTIES  ENVIRONMENT "ASAN_OPTIONS=quarantine_size_mb=16" _BACKTRACE_TRIPLES "/root/repo/test/CMakeLists.txt;56;add_test;/root/repo/test/CMakeLists.txt;64;openshock_add_fuzzer;/root/repo/test/CMakeLists.txt;0;")
+add_test([=[openshock-fuzz-response]=] "/root/repo/_gate_build_asan/test/openshock-fuzz-response" "-rss_limit_mb=256" "-timeout=2" "-runs=20000" "/root/repo/_gate_build_asan/test/openshock-fuzz-response-corpus" "/root/repo/test/fuzz/corpus/response")
+set_tests_properties([=[openshock-fuzz-response]=] PROPERTIES  ENVIRONMENT "ASAN_OPTIONS=quarantine_size_mb=16" _BACKTRACE_TRIPLES "/root/repo/test/CMakeLists.txt;56;add_test;/root/repo/test/CMakeLists.txt;65;openshock_add_fuzzer;/root/repo/test/CMakeLists.txt;0;")
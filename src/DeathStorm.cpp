@@ -0,0 +1,78 @@
+#include "DeathStorm.hpp"
+
+#include <algorithm> // for std::sort and std::count_if
+
+using namespace geode::prelude;
+
+namespace {
+    DeathStorm* s_current = nullptr;
+
+    float percentile(const std::vector<float>& sorted, float fraction) {
+        auto index = static_cast<std::size_t>(fraction * float(sorted.size() - 1));
+        return sorted[index];
+    }
+}
+
+bool DeathStorm::start(int count, float intervalSeconds, InjectFn inject) {
+    if (s_current || count <= 0) {
+        return false;
+    }
+
+    s_current = new DeathStorm(count, intervalSeconds, std::move(inject));
+
+    // Driven by the director's scheduler, so it keeps recording while the level is paused
+    CCDirector::get()->getScheduler()->scheduleUpdateForTarget(s_current, 0, false);
+    log::info("Death storm started: {} deaths, {:.0f}ms apart", count, intervalSeconds * 1000.f);
+    return true;
+}
+
+bool DeathStorm::isRunning() {
+    return s_current != nullptr;
+}
+
+DeathStorm::DeathStorm(int count, float intervalSeconds, InjectFn inject)
+    : m_inject(std::move(inject)), m_remaining(count), m_interval(intervalSeconds) {
+    m_frameTimesMs.reserve(4096);
+}
+
+void DeathStorm::update(float dt) {
+    m_frameTimesMs.push_back(dt * 1000.f);
+
+    if (m_remaining > 0) {
+        // At most one death per frame, so a short interval (or 0, burst mode) can't pile thousands into one update
+        m_untilNext -= dt;
+        if (m_untilNext <= 0.f) {
+            if (!m_inject()) {
+                log::warn("Death storm stopped early after {} deaths", m_injected);
+                m_remaining = 0;
+                m_settleTime = 0.f;
+                return;
+            }
+            m_injected++;
+            m_remaining--;
+            m_untilNext = m_interval;
+        }
+        return;
+    }
+
+    m_settleTime -= dt;
+    if (m_settleTime <= 0.f) {
+        finish();
+    }
+}
+
+void DeathStorm::finish() {
+    CCDirector::get()->getScheduler()->unscheduleUpdateForTarget(this);
+
+    auto sorted = m_frameTimesMs;
+    std::sort(sorted.begin(), sorted.end());
+    if (!sorted.empty()) {
+        float median = percentile(sorted, 0.5f);
+        auto hitches = std::count_if(sorted.begin(), sorted.end(), [median](float ms) { return ms > median * 2.f; });
+        log::info("Death storm finished: {} deaths over {} frames, frame time p50 {:.2f}ms, p95 {:.2f}ms, p99 {:.2f}ms, max {:.2f}ms, {} frames over 2x p50",
+            m_injected, sorted.size(), median, percentile(sorted, 0.95f), percentile(sorted, 0.99f), sorted.back(), hitches);
+    }
+
+    s_current = nullptr;
+    this->release();
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <Geode/Geode.hpp>
+
+#include <functional> // for std::function
+#include <vector> // for std::vector
+
+// Developer-only stress run: injects a burst of synthetic deaths into a live level and records
+// the frame times around them, so the mod's real hitch cost can be measured on each device
+class DeathStorm : public cocos2d::CCObject {
+public:
+    // Injects one synthetic death, returns false to end the storm early (e.g. the level was left)
+    using InjectFn = std::function<bool()>;
+
+    // Start a storm of `count` deaths spaced `intervalSeconds` apart, unless one is already running.
+    // At most one death is injected per frame, so an interval of 0 is burst mode: a death every frame.
+    static bool start(int count, float intervalSeconds, InjectFn inject);
+    static bool isRunning();
+
+    void update(float dt) override;
+
+private:
+    DeathStorm(int count, float intervalSeconds, InjectFn inject);
+    void finish();
+
+    InjectFn m_inject;
+    int m_remaining;
+    int m_injected = 0;
+    float m_interval;
+    float m_untilNext = 0.f;
+    float m_settleTime = 2.f; // keep recording after the last death while pop-ups and responses land
+    std::vector<float> m_frameTimesMs;
+};
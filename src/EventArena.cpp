@@ -0,0 +1,54 @@
+#include "EventArena.hpp"
+
+#include <new> // for operator new
+
+// Alignment is capped at max_align_t, which is all the arena's users ever need
+void* EventArena::allocate(std::size_t bytes, std::size_t alignment) {
+    std::size_t offset = (m_used + alignment - 1) & ~(alignment - 1);
+    if (offset + bytes <= kCapacity) {
+        m_used = offset + bytes;
+        return m_buffer + offset;
+    }
+    return ::operator new(bytes);
+}
+
+void EventArena::deallocate(void* pointer, std::size_t, std::size_t) {
+    if (!owns(pointer)) {
+        ::operator delete(pointer);
+    }
+}
+
+void EventArenaPool::Releaser::operator()(EventArena* arena) const {
+    EventArenaPool::get().release(arena);
+}
+
+EventArenaPool& EventArenaPool::get() {
+    static EventArenaPool pool;
+    return pool;
+}
+
+EventArenaPool::Handle EventArenaPool::acquire() {
+    std::unique_ptr<EventArena> arena;
+    {
+        std::lock_guard lock(m_mutex);
+        if (!m_free.empty()) {
+            arena = std::move(m_free.back());
+            m_free.pop_back();
+        }
+    }
+
+    if (!arena) {
+        arena = std::make_unique<EventArena>();
+    }
+    return Handle(arena.release());
+}
+
+void EventArenaPool::release(EventArena* arena) {
+    std::unique_ptr<EventArena> owned(arena);
+    owned->reset();
+
+    std::lock_guard lock(m_mutex);
+    if (m_free.size() < kMaxPooled) {
+        m_free.push_back(std::move(owned));
+    }
+}
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <cstddef> // for std::byte and std::max_align_t
+#include <memory> // for std::unique_ptr
+#include <mutex> // for std::mutex
+#include <string> // for std::basic_string
+#include <vector> // for std::vector
+
+// Fixed-size bump allocator for the temporaries of one in-flight shock, released all at once
+class EventArena {
+public:
+    static constexpr std::size_t kCapacity = 2048;
+
+    // Allocate from the arena, falling back to the heap once it's full
+    void* allocate(std::size_t bytes, std::size_t alignment);
+    // Only heap fallbacks are actually freed, arena memory is reclaimed by reset()
+    void deallocate(void* pointer, std::size_t bytes, std::size_t alignment);
+    void reset() { m_used = 0; }
+
+    std::size_t used() const { return m_used; }
+
+private:
+    bool owns(const void* pointer) const {
+        auto byte = static_cast<const std::byte*>(pointer);
+        return byte >= m_buffer && byte < m_buffer + kCapacity;
+    }
+
+    alignas(std::max_align_t) std::byte m_buffer[kCapacity];
+    std::size_t m_used = 0;
+};
+
+// Standard allocator adapter so containers and strings can live in an EventArena
+template <typename T>
+class ArenaAllocator {
+public:
+    using value_type = T;
+
+    explicit ArenaAllocator(EventArena& arena) noexcept : m_arena(&arena) {}
+    template <typename U>
+    ArenaAllocator(const ArenaAllocator<U>& other) noexcept : m_arena(other.arena()) {}
+
+    T* allocate(std::size_t count) {
+        return static_cast<T*>(m_arena->allocate(count * sizeof(T), alignof(T)));
+    }
+    void deallocate(T* pointer, std::size_t count) noexcept {
+        m_arena->deallocate(pointer, count * sizeof(T), alignof(T));
+    }
+
+    EventArena* arena() const noexcept { return m_arena; }
+
+    template <typename U>
+    bool operator==(const ArenaAllocator<U>& other) const noexcept { return m_arena == other.arena(); }
+
+private:
+    EventArena* m_arena;
+};
+
+using ArenaString = std::basic_string<char, std::char_traits<char>, ArenaAllocator<char>>;
+
+// Pool that recycles arenas between shocks so steady-state dispatch never touches the heap
+class EventArenaPool {
+public:
+    struct Releaser {
+        void operator()(EventArena* arena) const;
+    };
+    using Handle = std::unique_ptr<EventArena, Releaser>;
+
+    // Get the pool shared by the whole mod
+    static EventArenaPool& get();
+
+    // Take an empty arena from the pool, creating one if none are free
+    Handle acquire();
+
+private:
+    static constexpr std::size_t kMaxPooled = 4;
+
+    void release(EventArena* arena);
+
+    std::mutex m_mutex;
+    std::vector<std::unique_ptr<EventArena>> m_free;
+};
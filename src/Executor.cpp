@@ -0,0 +1,175 @@
+#include "Executor.hpp"
+
+#include <Geode/loader/Log.hpp> // for logging
+
+#include <algorithm> // for std::clamp
+#include <exception> // for std::exception
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <Windows.h>
+#elif defined(__APPLE__)
+#include <pthread.h>
+#else
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace {
+    // Queue capacity per priority class, in TaskPriority order
+    constexpr std::size_t kQueueCapacity[] = { 32, 256, 64 };
+}
+
+Executor& Executor::get() {
+    // Leave at least one core for the game and never use more than two threads
+    static Executor executor(std::clamp<std::size_t>(std::thread::hardware_concurrency(), 2, 3) - 1);
+    return executor;
+}
+
+Executor::Executor(std::size_t threadCount) : m_workers(std::max<std::size_t>(threadCount, 1)) {}
+
+Executor::~Executor() {
+    shutdown();
+}
+
+bool Executor::submit(TaskPriority priority, Task task) {
+    {
+        std::lock_guard lock(m_mutex);
+        auto& queue = m_queues[static_cast<std::size_t>(priority)];
+        if (m_stopping || queue.size() >= kQueueCapacity[static_cast<std::size_t>(priority)]) {
+            return false;
+        }
+
+        // Threads are only created once there is work for them
+        startWorkers();
+        queue.push_back(std::move(task));
+    }
+    m_wake.notify_one();
+    return true;
+}
+
+void Executor::enterGameplay() {
+    std::lock_guard lock(m_mutex);
+    if (m_stopping) {
+        return;
+    }
+    m_inGameplay = true;
+    startWorkers();
+}
+
+void Executor::leaveGameplay(std::chrono::milliseconds idleTimeout) {
+    {
+        std::lock_guard lock(m_mutex);
+        m_inGameplay = false;
+        m_idleTimeout = idleTimeout;
+    }
+    // Wake idle workers so they start counting down
+    m_wake.notify_all();
+}
+
+void Executor::shutdown() {
+    {
+        std::lock_guard lock(m_mutex);
+        if (m_stopping) {
+            return;
+        }
+        m_stopping = true;
+        m_queues[static_cast<std::size_t>(TaskPriority::Housekeeping)].clear();
+    }
+    m_wake.notify_all();
+
+    // Nothing touches the worker list once m_stopping is set, so it's safe to join without the lock
+    for (auto& worker : m_workers) {
+        if (worker.thread.joinable()) {
+            worker.thread.join();
+        }
+    }
+}
+
+// Start any worker that isn't running, must be called with m_mutex held
+void Executor::startWorkers() {
+    for (std::size_t i = 0; i < m_workers.size(); i++) {
+        auto& worker = m_workers[i];
+        if (worker.running) {
+            continue;
+        }
+
+        // A worker that idled out has already returned, so this join doesn't block
+        if (worker.thread.joinable()) {
+            worker.thread.join();
+        }
+        worker.running = true;
+        worker.thread = std::thread([this, i] { workerLoop(i); });
+    }
+}
+
+// Take the next task from the highest priority class that has work, must be called with m_mutex held
+bool Executor::takeTask(Task& task) {
+    for (auto& queue : m_queues) {
+        if (!queue.empty()) {
+            task = std::move(queue.front());
+            queue.pop_front();
+            return true;
+        }
+    }
+    return false;
+}
+
+void Executor::workerLoop(std::size_t index) {
+    lowerCurrentThreadPriority();
+
+    auto idleSince = std::chrono::steady_clock::now();
+    while (true) {
+        Task task;
+        {
+            std::unique_lock lock(m_mutex);
+            while (!takeTask(task)) {
+                // Remaining work is drained before exiting
+                if (m_stopping) {
+                    m_workers[index].running = false;
+                    return;
+                }
+
+                if (m_inGameplay) {
+                    m_wake.wait(lock);
+                    idleSince = std::chrono::steady_clock::now();
+                    continue;
+                }
+
+                // Outside gameplay, exit once there's been no work for the idle timeout
+                auto deadline = idleSince + m_idleTimeout;
+                if (std::chrono::steady_clock::now() >= deadline) {
+                    m_workers[index].running = false;
+                    return;
+                }
+                m_wake.wait_until(lock, deadline);
+            }
+        }
+
+        // A failing task must not take the worker (and the game) down with it
+        try {
+            task();
+        } catch (const std::exception& e) {
+            m_failedTasks++;
+            geode::log::error("Background task failed: {}", e.what());
+        } catch (...) {
+            m_failedTasks++;
+            geode::log::error("Background task failed with an unknown exception");
+        }
+        idleSince = std::chrono::steady_clock::now();
+    }
+}
+
+// Keep the workers below the render thread so they never steal a frame
+void Executor::lowerCurrentThreadPriority() {
+#if defined(_WIN32)
+    SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_BELOW_NORMAL);
+#elif defined(__APPLE__)
+    pthread_set_qos_class_self_np(QOS_CLASS_UTILITY, 0);
+#else
+    // On Linux and Android the nice value applies per thread
+    setpriority(PRIO_PROCESS, static_cast<id_t>(syscall(SYS_gettid)), 10);
+#endif
+}
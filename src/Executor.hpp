@@ -0,0 +1,72 @@
+#pragma once
+
+#include <array> // for std::array
+#include <atomic> // for std::atomic
+#include <chrono> // for std::chrono::milliseconds
+#include <condition_variable> // for std::condition_variable
+#include <cstddef> // for size_t
+#include <deque> // for std::deque
+#include <functional> // for std::function
+#include <mutex> // for std::mutex
+#include <thread> // for std::thread
+#include <vector> // for std::vector
+
+// Priority classes for background work, highest first
+enum class TaskPriority {
+    Dispatch, // sending shocks, unused for now since requests go out on Geode's own web thread
+    Journal, // recording what happened
+    Housekeeping, // flushing and cleanup that can wait
+};
+
+// Small pool of low-priority worker threads shared by every subsystem of the mod.
+// Workers are started on demand and exit once they've been idle for a while outside gameplay.
+class Executor {
+public:
+    using Task = std::function<void()>;
+
+    // Get the executor shared by the whole mod
+    static Executor& get();
+
+    explicit Executor(std::size_t threadCount);
+    ~Executor();
+    Executor(const Executor&) = delete;
+    Executor& operator=(const Executor&) = delete;
+
+    // Queue a task, returns false if that priority's queue is full or the executor is shutting down
+    bool submit(TaskPriority priority, Task task);
+
+    // Number of tasks that have thrown since the executor was created
+    std::size_t failedTaskCount() const { return m_failedTasks; }
+
+    // Start the workers now and keep them alive until gameplay ends
+    void enterGameplay();
+
+    // Let workers exit once they've had no work for `idleTimeout`
+    void leaveGameplay(std::chrono::milliseconds idleTimeout);
+
+    // Stop accepting work, drop queued housekeeping and wait for the workers to finish.
+    // Safe to call from any thread except a worker, and more than once.
+    void shutdown();
+
+private:
+    static constexpr std::size_t kPriorityCount = 3;
+
+    struct Worker {
+        std::thread thread;
+        bool running = false;
+    };
+
+    void startWorkers();
+    bool takeTask(Task& task);
+    void workerLoop(std::size_t index);
+    static void lowerCurrentThreadPriority();
+
+    std::mutex m_mutex;
+    std::condition_variable m_wake;
+    std::array<std::deque<Task>, kPriorityCount> m_queues;
+    std::vector<Worker> m_workers;
+    std::chrono::milliseconds m_idleTimeout{ 60000 };
+    bool m_inGameplay = false;
+    bool m_stopping = false;
+    std::atomic<std::size_t> m_failedTasks = 0;
+};
@@ -0,0 +1,146 @@
+#include "FileService.hpp"
+#include "Executor.hpp" // for running the file operations in the background
+
+#include <Geode/loader/Loader.hpp> // for queueInMainThread
+#include <Geode/loader/Log.hpp> // for logging
+
+#include <fstream> // for file reading and writing
+#include <iterator> // for std::istreambuf_iterator
+#include <memory> // for std::make_shared
+#include <system_error> // for std::error_code
+
+using namespace geode::prelude;
+
+FileService& FileService::get() {
+    static FileService service;
+    return service;
+}
+
+void FileService::read(const std::filesystem::path& path, ReadCallback callback) {
+    // The callback may hold a Ref to a game object, whose reference count isn't thread-safe, so the
+    // worker only ever moves it. It sits behind a pointer so a rejected task leaves it here to call.
+    auto pending = std::make_shared<ReadCallback>(std::move(callback));
+    bool queued = Executor::get().submit(TaskPriority::Journal, [this, path, pending] {
+        auto contents = readNow(path);
+        queueInMainThread([callback = std::move(*pending), contents = std::move(contents)]() mutable {
+            callback(std::move(contents));
+        });
+    });
+
+    if (!queued) {
+        log::error("File queue is full, couldn't read {}", path.string());
+        queueInMainThread([callback = std::move(*pending)] { callback(std::nullopt); });
+    }
+}
+
+std::future<std::optional<std::string>> FileService::read(const std::filesystem::path& path) {
+    auto promise = std::make_shared<std::promise<std::optional<std::string>>>();
+    auto future = promise->get_future();
+
+    bool queued = Executor::get().submit(TaskPriority::Journal, [this, path, promise] {
+        promise->set_value(readNow(path));
+    });
+
+    if (!queued) {
+        log::error("File queue is full, couldn't read {}", path.string());
+        promise->set_value(std::nullopt);
+    }
+    return future;
+}
+
+void FileService::write(const std::filesystem::path& path, std::string contents) {
+    {
+        std::lock_guard lock(m_mutex);
+        auto& pending = m_writes[path];
+        pending.contents = std::move(contents);
+
+        // A write for this file is already queued and will pick up the new contents
+        if (pending.queued) {
+            return;
+        }
+        pending.queued = true;
+    }
+
+    if (!Executor::get().submit(TaskPriority::Journal, [this, path] { flushWrites(path); })) {
+        log::error("File queue is full, couldn't write {}", path.string());
+        std::lock_guard lock(m_mutex);
+        m_writes.erase(path);
+    }
+}
+
+std::optional<std::string> FileService::readNow(const std::filesystem::path& path) {
+    // Serve writes that haven't reached the disk yet so readers never see stale contents
+    {
+        std::lock_guard lock(m_mutex);
+        if (auto it = m_writes.find(path); it != m_writes.end()) {
+            if (it->second.contents) {
+                return it->second.contents;
+            }
+            if (it->second.writing) {
+                return *it->second.writing;
+            }
+        }
+    }
+
+    std::error_code ec;
+    auto size = std::filesystem::file_size(path, ec);
+    if (ec) {
+        return std::nullopt;
+    }
+    if (size > kMaxReadSize) {
+        log::error("Refusing to read {}: {} bytes is over the {} byte limit", path.string(), size, kMaxReadSize);
+        return std::nullopt;
+    }
+
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        return std::nullopt;
+    }
+    return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+}
+
+// Write the latest contents for a file until no newer contents are waiting
+void FileService::flushWrites(const std::filesystem::path& path) {
+    while (true) {
+        std::shared_ptr<const std::string> contents;
+        {
+            std::lock_guard lock(m_mutex);
+            auto it = m_writes.find(path);
+            if (it == m_writes.end()) {
+                return;
+            }
+            if (!it->second.contents) {
+                m_writes.erase(it);
+                return;
+            }
+            contents = std::make_shared<const std::string>(std::move(*it->second.contents));
+            it->second.contents.reset();
+            it->second.writing = contents;
+        }
+
+        if (!writeNow(path, *contents)) {
+            log::error("Failed to write {}", path.string());
+        }
+    }
+}
+
+// Write to a temporary file first so a crash never leaves a half-written file behind
+bool FileService::writeNow(const std::filesystem::path& path, const std::string& contents) {
+    auto tempPath = path;
+    tempPath += ".tmp";
+
+    {
+        std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+        if (!file.is_open()) {
+            return false;
+        }
+        file.write(contents.data(), std::streamsize(contents.size()));
+        if (!file) {
+            return false;
+        }
+    }
+
+    std::error_code ec;
+    std::filesystem::rename(tempPath, path, ec);
+    return !ec;
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstdint> // for std::uintmax_t
+#include <filesystem> // for std::filesystem::path
+#include <functional> // for std::function
+#include <future> // for std::future
+#include <memory> // for std::shared_ptr
+#include <mutex> // for std::mutex
+#include <optional> // for std::optional
+#include <string> // for std::string
+#include <unordered_map> // for std::unordered_map
+
+// Reads and writes whole files on the background executor so the game thread never waits on storage
+class FileService {
+public:
+    // Files larger than this are refused, so a stray huge file can't balloon memory
+    static constexpr std::uintmax_t kMaxReadSize = 4 * 1024 * 1024;
+
+    // Receives the file contents, or std::nullopt if the file couldn't be read
+    using ReadCallback = std::function<void(std::optional<std::string>)>;
+
+    // Get the file service shared by the whole mod
+    static FileService& get();
+
+    // Read a file in the background and deliver the contents on the main thread
+    void read(const std::filesystem::path& path, ReadCallback callback);
+
+    // Read a file in the background, for callers that aren't on the main thread
+    std::future<std::optional<std::string>> read(const std::filesystem::path& path);
+
+    // Write a file in the background. Writes to the same file that are still queued
+    // are coalesced so only the latest contents reach the disk.
+    void write(const std::filesystem::path& path, std::string contents);
+
+private:
+    struct PendingWrite {
+        std::optional<std::string> contents; // latest contents not yet picked up by the writer
+        std::shared_ptr<const std::string> writing; // contents currently being written
+        bool queued = false;
+    };
+
+    struct PathHash {
+        std::size_t operator()(const std::filesystem::path& path) const {
+            return std::filesystem::hash_value(path);
+        }
+    };
+
+    std::optional<std::string> readNow(const std::filesystem::path& path);
+    void flushWrites(const std::filesystem::path& path);
+    static bool writeNow(const std::filesystem::path& path, const std::string& contents);
+
+    std::mutex m_mutex;
+    std::unordered_map<std::filesystem::path, PendingWrite, PathHash> m_writes;
+};
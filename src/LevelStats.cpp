@@ -0,0 +1,448 @@
+#include "LevelStats.hpp"
+
+#include <algorithm> // for std::clamp and std::max
+#include <cstring> // for std::memset
+#include <limits> // for std::numeric_limits
+#include <system_error> // for std::error_code
+#include <vector> // for std::vector
+
+#include <Geode/loader/Log.hpp> // for logging
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace {
+    constexpr uint32_t kMagic = 0x53475354; // "TSGS"
+    constexpr uint32_t kVersion = 1;
+    constexpr std::size_t kInitialCapacity = 1024; // must be a power of two
+    constexpr int32_t kEmptySlot = std::numeric_limits<int32_t>::min();
+    constexpr std::size_t kMaxPendingUpdates = 256; // held before the store opens, later ones are dropped
+
+    // Fibonacci hashing spreads sequential level IDs across the table
+    std::size_t slotFor(int32_t levelID, std::size_t capacity) {
+        uint64_t hash = static_cast<uint32_t>(levelID) * 0x9E3779B97F4A7C15ull;
+        return static_cast<std::size_t>(hash >> 32) & (capacity - 1);
+    }
+
+    void clearRecord(LevelRecord& record) {
+        std::memset(&record, 0, sizeof(record));
+        record.levelID = kEmptySlot;
+    }
+}
+
+// File header, followed directly by `capacity` records
+struct LevelStatsStore::Header {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t capacity;
+    uint32_t count;
+    uint32_t reserved[4];
+};
+
+LevelStatsStore& LevelStatsStore::get() {
+    static LevelStatsStore store;
+    return store;
+}
+
+LevelStatsStore::~LevelStatsStore() {
+    close();
+}
+
+// The file is mapped and prepared without the table lock, which is only held to swap the mapping in,
+// so the game thread never waits on file I/O to record an update
+bool LevelStatsStore::open(const std::filesystem::path& path) {
+    static_assert(sizeof(Header) % alignof(LevelRecord) == 0, "records must stay aligned after the header");
+
+    std::lock_guard growLock(m_growMutex);
+    Mapping mapping;
+    if (!mapTable(path, mapping)) {
+        return false;
+    }
+
+    Mapping old;
+    {
+        std::lock_guard lock(m_mutex);
+        old = releaseLocked();
+        m_path = path;
+        adopt(mapping);
+        replayPendingLocked();
+    }
+    flushRegion(old);
+    unmapRegion(old);
+    return true;
+}
+
+void LevelStatsStore::close() {
+    std::lock_guard growLock(m_growMutex);
+    Mapping old;
+    {
+        std::lock_guard lock(m_mutex);
+        old = releaseLocked();
+    }
+    flushRegion(old);
+    unmapRegion(old);
+}
+
+bool LevelStatsStore::isOpen() const {
+    std::lock_guard lock(m_mutex);
+    return m_header != nullptr;
+}
+
+void LevelStatsStore::recordAttempt(int32_t levelID) {
+    std::lock_guard lock(m_mutex);
+    recordLocked({ PendingUpdate::Kind::Attempt, levelID, 0, 0 });
+}
+
+void LevelStatsStore::recordDeath(int32_t levelID, int percent) {
+    std::lock_guard lock(m_mutex);
+    recordLocked({ PendingUpdate::Kind::Death, levelID, percent, 0 });
+}
+
+void LevelStatsStore::recordShock(int32_t levelID, int intensity, int durationMs) {
+    std::lock_guard lock(m_mutex);
+    recordLocked({ PendingUpdate::Kind::Shock, levelID, intensity, durationMs });
+}
+
+// Apply an update, or hold on to it until the store is open
+void LevelStatsStore::recordLocked(const PendingUpdate& update) {
+    if (m_header) {
+        applyLocked(update);
+    } else if (update.levelID != kUntrackedLevelID && m_pending.size() < kMaxPendingUpdates) {
+        m_pending.push_back(update);
+    }
+}
+
+void LevelStatsStore::applyLocked(const PendingUpdate& update) {
+    auto record = findOrInsert(update.levelID);
+    if (!record) {
+        return;
+    }
+
+    switch (update.kind) {
+        case PendingUpdate::Kind::Attempt:
+            record->attempts++;
+            break;
+        case PendingUpdate::Kind::Death: {
+            record->deaths++;
+            auto bin = static_cast<std::size_t>(std::clamp(update.first, 0, int(kHistogramBins) - 1));
+            if (record->histogram[bin] != std::numeric_limits<uint16_t>::max()) {
+                record->histogram[bin]++;
+            }
+            break;
+        }
+        case PendingUpdate::Kind::Shock:
+            record->shocks++;
+            record->cumulativeDose += uint64_t(std::max(update.first, 0)) * uint64_t(std::max(update.second, 0));
+            break;
+    }
+}
+
+// Apply the updates made before the store was opened
+void LevelStatsStore::replayPendingLocked() {
+    for (const auto& update : m_pending) {
+        applyLocked(update);
+    }
+    m_pending.clear();
+}
+
+std::optional<LevelRecord> LevelStatsStore::find(int32_t levelID) const {
+    std::lock_guard lock(m_mutex);
+    if (!m_header || levelID == kEmptySlot) {
+        return std::nullopt;
+    }
+
+    std::size_t capacity = m_header->capacity;
+    for (std::size_t i = slotFor(levelID, capacity), probes = 0; probes < capacity; i = (i + 1) & (capacity - 1), probes++) {
+        if (m_records[i].levelID == levelID) {
+            return m_records[i];
+        }
+        if (m_records[i].levelID == kEmptySlot) {
+            return std::nullopt;
+        }
+    }
+    return std::nullopt;
+}
+
+void LevelStatsStore::flush() {
+    std::lock_guard lock(m_mutex);
+    flushRegion(m_mapping);
+}
+
+// Double the table into a temporary file while updates carry on, then swap it in
+void LevelStatsStore::reserveForNewLevel() {
+    // Two grows at once would build the same temporary file, so grows take turns with each other
+    // and with open() and close()
+    std::lock_guard growLock(m_growMutex);
+
+    std::filesystem::path path;
+    std::vector<LevelRecord> live;
+    std::size_t newCapacity;
+    uint64_t generation;
+    {
+        std::lock_guard lock(m_mutex);
+        if (!m_header || (std::size_t(m_header->count) + 1) * 4 <= std::size_t(m_header->capacity) * 3) {
+            return;
+        }
+
+        path = m_path;
+        newCapacity = std::size_t(m_header->capacity) * 2;
+        generation = m_generation;
+        live.reserve(m_header->count);
+        for (std::size_t i = 0; i < m_header->capacity; i++) {
+            if (m_records[i].levelID != kEmptySlot) {
+                live.push_back(m_records[i]);
+            }
+        }
+    }
+
+    auto tempPath = path;
+    tempPath += ".tmp";
+    Mapping grown;
+    if (!mapRegion(tempPath, sizeof(Header) + newCapacity * sizeof(LevelRecord), true, grown)) {
+        return;
+    }
+
+    auto header = static_cast<Header*>(grown.view);
+    auto records = reinterpret_cast<LevelRecord*>(static_cast<char*>(grown.view) + sizeof(Header));
+    auto rehash = [&](const LevelRecord* source, std::size_t count) {
+        initializeTable(grown, newCapacity);
+        for (std::size_t n = 0; n < count; n++) {
+            if (source[n].levelID == kEmptySlot) {
+                continue;
+            }
+            std::size_t i = slotFor(source[n].levelID, newCapacity);
+            while (records[i].levelID != kEmptySlot) {
+                i = (i + 1) & (newCapacity - 1);
+            }
+            records[i] = source[n];
+            header->count++;
+        }
+    };
+    rehash(live.data(), live.size());
+
+    // Only the in-memory swap happens under the table lock. Opening and closing wait for m_growMutex,
+    // so the store is still on the same file and nothing unmaps the new table behind our back.
+    Mapping old;
+    {
+        std::lock_guard lock(m_mutex);
+
+        // Updates that landed while the new table was being built are copied over in memory
+        if (m_generation != generation) {
+            rehash(m_records, m_header->capacity);
+        }
+        old = releaseLocked();
+        adopt(grown);
+    }
+
+    // Windows can't replace a file that is still mapped, so the old table goes first
+    flushRegion(grown);
+    unmapRegion(old);
+    std::error_code ec;
+    std::filesystem::rename(tempPath, path, ec);
+    if (ec) {
+        // The table lives on in the temporary file, later grows must build next to that one instead
+        geode::log::error("Couldn't replace {} with the grown statistics table: {}, it stays in {}",
+            path.string(), ec.message(), tempPath.string());
+        std::lock_guard lock(m_mutex);
+        m_path = tempPath;
+    }
+}
+
+LevelRecord* LevelStatsStore::findOrInsert(int32_t levelID) {
+    if (!m_header || levelID == kEmptySlot || levelID == kUntrackedLevelID) {
+        return nullptr;
+    }
+    m_generation++;
+
+    std::size_t capacity = m_header->capacity;
+    for (std::size_t i = slotFor(levelID, capacity);; i = (i + 1) & (capacity - 1)) {
+        if (m_records[i].levelID == levelID) {
+            return &m_records[i];
+        }
+        if (m_records[i].levelID == kEmptySlot) {
+            // Growing is left to reserveForNewLevel(), past 7/8 full new levels are dropped instead
+            if ((std::size_t(m_header->count) + 1) * 8 > capacity * 7) {
+                return nullptr;
+            }
+            m_records[i].levelID = levelID;
+            m_header->count++;
+            return &m_records[i];
+        }
+    }
+}
+
+// Map `size` bytes of the file, creating it or setting its size first when `truncate` is set
+bool LevelStatsStore::mapRegion(const std::filesystem::path& path, std::size_t size, bool truncate, Mapping& out) {
+#ifdef _WIN32
+    // FILE_SHARE_DELETE lets a freshly grown table be renamed over the old one while it's mapped
+    HANDLE file = CreateFileW(path.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ | FILE_SHARE_DELETE, nullptr, OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+
+    LARGE_INTEGER fileSize;
+    if (truncate || (GetFileSizeEx(file, &fileSize) && std::size_t(fileSize.QuadPart) < size)) {
+        LARGE_INTEGER newSize;
+        newSize.QuadPart = LONGLONG(size);
+        if (!SetFilePointerEx(file, newSize, nullptr, FILE_BEGIN) || !SetEndOfFile(file)) {
+            CloseHandle(file);
+            return false;
+        }
+    }
+
+    HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READWRITE, DWORD(uint64_t(size) >> 32), DWORD(size & 0xFFFFFFFF), nullptr);
+    if (!mapping) {
+        CloseHandle(file);
+        return false;
+    }
+
+    void* view = MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0, size);
+    if (!view) {
+        CloseHandle(mapping);
+        CloseHandle(file);
+        return false;
+    }
+
+    out.fileHandle = file;
+    out.mappingHandle = mapping;
+#else
+    int fd = ::open(path.c_str(), O_RDWR | O_CREAT, 0644);
+    if (fd < 0) {
+        return false;
+    }
+
+    std::error_code ec;
+    if (truncate || std::filesystem::file_size(path, ec) < size || ec) {
+        if (ftruncate(fd, off_t(size)) != 0) {
+            ::close(fd);
+            return false;
+        }
+    }
+
+    void* view = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (view == MAP_FAILED) {
+        ::close(fd);
+        return false;
+    }
+
+    out.fd = fd;
+#endif
+
+    out.view = view;
+    out.size = size;
+    return true;
+}
+
+void LevelStatsStore::unmapRegion(Mapping& mapping) {
+#ifdef _WIN32
+    if (mapping.view) {
+        UnmapViewOfFile(mapping.view);
+    }
+    if (mapping.mappingHandle) {
+        CloseHandle(mapping.mappingHandle);
+    }
+    if (mapping.fileHandle) {
+        CloseHandle(mapping.fileHandle);
+    }
+#else
+    if (mapping.view) {
+        munmap(mapping.view, mapping.size);
+    }
+    if (mapping.fd >= 0) {
+        ::close(mapping.fd);
+    }
+#endif
+    mapping = Mapping();
+}
+
+void LevelStatsStore::flushRegion(const Mapping& mapping) {
+    if (!mapping.view) {
+        return;
+    }
+#ifdef _WIN32
+    FlushViewOfFile(mapping.view, 0);
+#else
+    msync(mapping.view, mapping.size, MS_ASYNC);
+#endif
+}
+
+// Map the table in the file, or a fresh one if the file is missing or isn't a valid table
+bool LevelStatsStore::mapTable(const std::filesystem::path& path, Mapping& out) {
+    std::error_code ec;
+    auto fileSize = std::filesystem::exists(path, ec) ? std::filesystem::file_size(path, ec) : 0;
+    if (!ec && fileSize > 0) {
+        Header header{};
+        bool valid = false;
+        if (fileSize >= sizeof(Header)) {
+            // Map just the header first to learn the capacity
+            Mapping headerOnly;
+            if (!mapRegion(path, sizeof(Header), false, headerOnly)) {
+                return false;
+            }
+            header = *static_cast<Header*>(headerOnly.view);
+            unmapRegion(headerOnly);
+
+            valid = header.magic == kMagic && header.version == kVersion
+                && header.capacity != 0 && (header.capacity & (header.capacity - 1)) == 0
+                && fileSize == sizeof(Header) + std::size_t(header.capacity) * sizeof(LevelRecord);
+        }
+        if (valid) {
+            return mapRegion(path, fileSize, false, out);
+        }
+
+        // Keep the player's history for recovery (or a future format upgrade) instead of overwriting it
+        auto badPath = path;
+        badPath += ".bad";
+        std::filesystem::rename(path, badPath, ec);
+        if (ec) {
+            geode::log::error("{} isn't a valid statistics file (magic {:#x}, version {}, capacity {}, {} bytes) and couldn't be moved aside: {}",
+                path.string(), header.magic, header.version, header.capacity, fileSize, ec.message());
+            return false;
+        }
+        geode::log::error("{} isn't a valid statistics file (magic {:#x}, version {}, capacity {}, {} bytes), moved it to {} and started a new one",
+            path.string(), header.magic, header.version, header.capacity, fileSize, badPath.string());
+    }
+
+    // Missing or empty file, or an invalid one that has been moved aside, start a fresh table
+    if (!mapRegion(path, sizeof(Header) + kInitialCapacity * sizeof(LevelRecord), true, out)) {
+        return false;
+    }
+    initializeTable(out, kInitialCapacity);
+    return true;
+}
+
+// Write an empty table with room for `capacity` records into a mapping
+void LevelStatsStore::initializeTable(const Mapping& mapping, std::size_t capacity) {
+    auto header = static_cast<Header*>(mapping.view);
+    auto records = reinterpret_cast<LevelRecord*>(static_cast<char*>(mapping.view) + sizeof(Header));
+    std::memset(header, 0, sizeof(Header));
+    header->magic = kMagic;
+    header->version = kVersion;
+    header->capacity = uint32_t(capacity);
+    for (std::size_t i = 0; i < capacity; i++) {
+        clearRecord(records[i]);
+    }
+}
+
+// Make a mapping the store's table
+void LevelStatsStore::adopt(Mapping mapping) {
+    m_mapping = mapping;
+    m_header = static_cast<Header*>(mapping.view);
+    m_records = reinterpret_cast<LevelRecord*>(static_cast<char*>(mapping.view) + sizeof(Header));
+}
+
+// Take the store's table away so it can be unmapped after the lock is released
+LevelStatsStore::Mapping LevelStatsStore::releaseLocked() {
+    Mapping mapping = m_mapping;
+    m_mapping = Mapping();
+    m_header = nullptr;
+    m_records = nullptr;
+    return mapping;
+}
@@ -0,0 +1,107 @@
+#pragma once
+
+#include <cstddef> // for size_t
+#include <cstdint> // for fixed-width integer types
+#include <filesystem> // for std::filesystem::path
+#include <mutex> // for std::mutex
+#include <optional> // for std::optional
+#include <vector> // for std::vector
+
+// Local and editor levels all share ID 0, so they can't be told apart and aren't tracked
+constexpr int32_t kUntrackedLevelID = 0;
+
+// Number of bins in the death-percent histogram (one per percent, 100% folds into the last bin)
+constexpr std::size_t kHistogramBins = 100;
+
+// One level's statistics, stored as-is in the memory-mapped file
+struct LevelRecord {
+    int32_t levelID;
+    uint32_t attempts;
+    uint32_t deaths;
+    uint32_t shocks;
+    uint64_t cumulativeDose; // sum of intensity * duration (ms) over every shock sent
+    uint16_t histogram[kHistogramBins]; // deaths per percent, saturating
+};
+
+static_assert(sizeof(LevelRecord) == 224, "LevelRecord layout is part of the file format");
+
+// Per-level statistics persisted in an open-addressing hash table that is memory-mapped from disk.
+// All methods are thread-safe so flushing can happen off the game thread.
+class LevelStatsStore {
+public:
+    // Get the store shared by the whole mod
+    static LevelStatsStore& get();
+
+    LevelStatsStore() = default;
+    ~LevelStatsStore();
+    LevelStatsStore(const LevelStatsStore&) = delete;
+    LevelStatsStore& operator=(const LevelStatsStore&) = delete;
+
+    // Map the stats file at the given path, creating it if it doesn't exist. On failure the store is left as it was.
+    bool open(const std::filesystem::path& path);
+    void close();
+    bool isOpen() const;
+
+    // Record updates, always O(1). The table never grows here; an update for a new level
+    // is dropped if the table is nearly full, which reserveForNewLevel() prevents.
+    // Updates made before the store is open are held and applied once it opens.
+    void recordAttempt(int32_t levelID);
+    void recordDeath(int32_t levelID, int percent);
+    void recordShock(int32_t levelID, int intensity, int durationMs);
+
+    // Get a copy of a level's record, std::nullopt if the level has no stats yet
+    std::optional<LevelRecord> find(int32_t levelID) const;
+
+    // Ask the OS to write dirty pages back to disk
+    void flush();
+
+    // Grow the table ahead of time if one more level would push it past its load factor.
+    // This does file I/O, so call it from the executor, e.g. when a level is loaded.
+    void reserveForNewLevel();
+
+private:
+    struct Header;
+
+    // An update made while the store isn't open yet
+    struct PendingUpdate {
+        enum class Kind { Attempt, Death, Shock } kind;
+        int32_t levelID;
+        int first; // death percent, or shock intensity
+        int second; // shock duration in ms
+    };
+
+    // A file mapped read-write into memory
+    struct Mapping {
+        void* view = nullptr;
+        std::size_t size = 0;
+#ifdef _WIN32
+        void* fileHandle = nullptr;
+        void* mappingHandle = nullptr;
+#else
+        int fd = -1;
+#endif
+    };
+
+    static bool mapRegion(const std::filesystem::path& path, std::size_t size, bool truncate, Mapping& out);
+    static void unmapRegion(Mapping& mapping);
+    static void flushRegion(const Mapping& mapping);
+
+    static bool mapTable(const std::filesystem::path& path, Mapping& out);
+    static void initializeTable(const Mapping& mapping, std::size_t capacity);
+
+    void applyLocked(const PendingUpdate& update);
+    void recordLocked(const PendingUpdate& update);
+    void replayPendingLocked();
+    LevelRecord* findOrInsert(int32_t levelID);
+    void adopt(Mapping mapping);
+    Mapping releaseLocked();
+
+    mutable std::mutex m_mutex;
+    std::mutex m_growMutex; // held across file I/O in open(), close() and reserveForNewLevel(), always taken before m_mutex
+    std::filesystem::path m_path;
+    Mapping m_mapping;
+    Header* m_header = nullptr;
+    LevelRecord* m_records = nullptr;
+    std::vector<PendingUpdate> m_pending;
+    uint64_t m_generation = 0; // bumped on every update, so a background grow can tell it missed some
+};
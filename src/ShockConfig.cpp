@@ -0,0 +1,128 @@
+#include "ShockConfig.hpp"
+
+#include <fmt/format.h> // for fmt::format
+
+#include <algorithm> // for std::clamp
+#include <limits> // for std::numeric_limits
+#include <stdexcept> // for std::runtime_error
+
+using json = nlohmann::json;
+
+namespace {
+    ResolvedShockConfig failure(std::string logMessage, std::string popupMessage) {
+        return { std::nullopt, std::move(logMessage), std::move(popupMessage) };
+    }
+
+    // Read an integer field, `fallback` if it's missing. Anything that isn't an integer that fits in an
+    // int is rejected before it's narrowed, json's own conversion is undefined for 1e20 and wraps 3000000000.
+    int intField(const json& source, const char* key, int fallback) {
+        auto field = source.find(key);
+        if (field == source.end()) {
+            return fallback;
+        }
+
+        constexpr auto min = std::numeric_limits<int>::min();
+        constexpr auto max = std::numeric_limits<int>::max();
+        bool inRange = field->is_number_unsigned() ? field->get<uint64_t>() <= uint64_t(max)
+            : field->is_number_integer() && field->get<int64_t>() >= min && field->get<int64_t>() <= max;
+        if (!inRange) {
+            throw std::runtime_error(fmt::format("{} must be an integer between {} and {}, got {}", key, min, max, field->dump()));
+        }
+        return static_cast<int>(field->get<int64_t>());
+    }
+
+    // Apply the range fields present in `source` on top of `config`
+    void applyRanges(ShockConfig& config, const json& source) {
+        config.minDuration = intField(source, "minDuration", config.minDuration);
+        config.maxDuration = intField(source, "maxDuration", config.maxDuration);
+        config.minIntensity = intField(source, "minIntensity", config.minIntensity);
+        config.maxIntensity = intField(source, "maxIntensity", config.maxIntensity);
+    }
+}
+
+ResolvedShockConfig parseShockConfig(const std::optional<std::string>& contents, int32_t levelID) {
+    constexpr auto invalidConfig = "Error: Invalid config file! Read readme.txt in the mod's config folder.";
+
+    if (!contents) {
+        return failure("Failed to open settings.json file in config directory",
+            "Error: Missing config file! Read readme.txt in the mod's config folder.");
+    }
+
+    if (contents->size() > kMaxSettingsSize) {
+        return failure(fmt::format("settings.json is too large: {} bytes, the limit is {}", contents->size(), kMaxSettingsSize), invalidConfig);
+    }
+
+    json configJson;
+    try {
+        // Abort as soon as the nesting gets too deep instead of building the whole tree
+        configJson = json::parse(*contents, [](int depth, json::parse_event_t, json&) {
+            if (depth > kMaxSettingsDepth) {
+                throw std::runtime_error(fmt::format("nesting deeper than {} levels", kMaxSettingsDepth));
+            }
+            return true;
+        });
+    } catch (const std::exception& e) {
+        return failure(fmt::format("Error parsing JSON file: {}", e.what()), invalidConfig);
+    }
+
+    return resolveShockConfig(configJson, levelID);
+}
+
+ResolvedShockConfig resolveShockConfig(const json& settings, int32_t levelID) {
+    constexpr auto invalidConfig = "Error: Invalid config file! Read readme.txt in the mod's config folder.";
+
+    if (!settings.is_object()) {
+        return failure("settings.json is not a JSON object", invalidConfig);
+    }
+
+    ShockConfig config;
+    try {
+        applyRanges(config, settings);
+
+        // Per-level overrides are keyed by the level ID as a string
+        if (auto overrides = settings.find("levelOverrides"); overrides != settings.end() && overrides->is_object()) {
+            if (auto level = overrides->find(std::to_string(levelID)); level != overrides->end() && level->is_object()) {
+                applyRanges(config, *level);
+            }
+        }
+
+        config.idleTimeoutSeconds = intField(settings, "idleTimeout", config.idleTimeoutSeconds);
+        if (auto storm = settings.find("devDeathStorm"); storm != settings.end() && storm->is_object()) {
+            config.devStormCount = std::clamp(intField(*storm, "count", 50), 0, 10000);
+            config.devStormIntervalMs = std::clamp(intField(*storm, "intervalMs", config.devStormIntervalMs), 0, 60000);
+        }
+
+        config.shockerID = settings.value("shockerID", "");
+        config.openShockToken = settings.value("OpenShockToken", "");
+        config.customName = settings.value("customName", "");
+
+        // Get the endpoint domain, default to api.openshock.app if missing or empty
+        config.endpointDomain = settings.value("endpointDomain", "api.openshock.app");
+        if (config.endpointDomain.empty()) {
+            config.endpointDomain = "api.openshock.app";
+        }
+    } catch (const std::exception& e) {
+        return failure(fmt::format("Invalid field in config: {}", e.what()), invalidConfig);
+    }
+
+    if (config.minDuration < 300 || config.maxDuration > 30000 || config.minDuration > config.maxDuration) {
+        return failure(fmt::format("Invalid duration range in config for level {}: minDuration={}, maxDuration={}",
+            levelID, config.minDuration, config.maxDuration), invalidConfig);
+    }
+
+    if (config.minIntensity < 1 || config.maxIntensity > 100 || config.minIntensity > config.maxIntensity) {
+        return failure(fmt::format("Invalid intensity range in config for level {}: minIntensity={}, maxIntensity={}",
+            levelID, config.minIntensity, config.maxIntensity), invalidConfig);
+    }
+
+    if (config.idleTimeoutSeconds < 0) {
+        return failure(fmt::format("Invalid idle timeout in config: idleTimeout={}", config.idleTimeoutSeconds), invalidConfig);
+    }
+
+    if (config.shockerID.empty() || config.openShockToken.empty() || config.customName.empty()) {
+        return failure("Missing required fields in JSON configuration",
+            "Error: Missing required fields in config file! Read readme.txt in the mod's config folder.");
+    }
+
+    return { std::move(config), "", "" };
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include "json.hpp" // Include nlohmann::json for JSON parsing
+
+#include <cstddef> // for size_t
+#include <cstdint> // for int32_t
+#include <optional> // for std::optional
+#include <string> // for std::string
+
+// Shock settings for one level, with any per-level override already applied
+struct ShockConfig {
+    std::string shockerID;
+    std::string openShockToken;
+    std::string customName;
+    std::string endpointDomain;
+    int minDuration = 300;
+    int maxDuration = 30000;
+    int minIntensity = 1;
+    int maxIntensity = 100;
+    int idleTimeoutSeconds = 60; // how long background work stays up after leaving a level
+
+    // Death storm stress run, only used by builds with OPENSHOCK_DEV_TOOLS
+    int devStormCount = 0; // 0 disables it
+    int devStormIntervalMs = 100; // 0 is burst mode, one death every frame
+};
+
+// Result of resolving the config for a level, either a usable config or the reason it isn't
+struct ResolvedShockConfig {
+    std::optional<ShockConfig> config;
+    std::string logMessage; // detailed error for the log
+    std::string popupMessage; // error shown to the player
+};
+
+// Largest settings.json accepted and deepest nesting allowed in it, so parsing cost stays bounded for any input
+constexpr std::size_t kMaxSettingsSize = 64 * 1024;
+constexpr int kMaxSettingsDepth = 16;
+
+// Parse the contents of settings.json (std::nullopt if it couldn't be read) and resolve them for a level
+ResolvedShockConfig parseShockConfig(const std::optional<std::string>& contents, int32_t levelID);
+
+// Merge the global settings with the override for the given level and validate the result
+ResolvedShockConfig resolveShockConfig(const nlohmann::json& settings, int32_t levelID);
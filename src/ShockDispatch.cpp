@@ -0,0 +1,76 @@
+#include "ShockDispatch.hpp"
+
+#include <fmt/format.h> // for fmt::format_to
+
+#include <iterator> // for std::back_inserter
+
+ShockDispatch::ShockDispatch() : m_random(std::random_device{}()) {}
+
+ShockDispatch::Request ShockDispatch::begin(const ShockConfig& config) {
+    release();
+    m_ticket++;
+
+    // Generate random intensity and duration within the valid ranges
+    int intensity = std::uniform_int_distribution<>(config.minIntensity, config.maxIntensity)(m_random);
+    int durationMs = std::uniform_int_distribution<>(config.minDuration, config.maxDuration)(m_random);
+
+    // All temporaries of this shock come from one pooled arena
+    m_arena = EventArenaPool::get().acquire();
+    auto& body = m_body.emplace(ArenaAllocator<char>(*m_arena));
+    auto& url = m_url.emplace(ArenaAllocator<char>(*m_arena));
+    auto& summary = m_summary.emplace(ArenaAllocator<char>(*m_arena));
+
+    // Build the JSON request body directly into the arena
+    body.reserve(256);
+    body += R"({"shocks":[{"id":)";
+    appendJsonString(body, config.shockerID);
+    fmt::format_to(std::back_inserter(body), R"(,"type":"Shock","intensity":{},"duration":{},"exclusive":true}}],"customName":)",
+        intensity, durationMs);
+    appendJsonString(body, config.customName);
+    body += '}';
+
+    fmt::format_to(std::back_inserter(url), "https://{}/2/shockers/control", config.endpointDomain);
+    fmt::format_to(std::back_inserter(summary), "Duration: {}s     Intensity: {}", durationMs / 1000, intensity);
+
+    return { m_ticket, intensity, durationMs, body, url };
+}
+
+bool ShockDispatch::finish(Ticket ticket) {
+    if (ticket != m_ticket || !inFlight()) {
+        return false;
+    }
+    release();
+    return true;
+}
+
+std::string_view ShockDispatch::summary() const {
+    return m_summary ? std::string_view(*m_summary) : std::string_view();
+}
+
+// Return the arena to the pool, after the strings that live in it
+void ShockDispatch::release() {
+    m_body.reset();
+    m_url.reset();
+    m_summary.reset();
+    m_arena.reset();
+}
+
+void appendJsonString(ArenaString& out, std::string_view value) {
+    out += '"';
+    for (char c : value) {
+        switch (c) {
+            case '"': out += "\\\""; break;
+            case '\\': out += "\\\\"; break;
+            case '\n': out += "\\n"; break;
+            case '\r': out += "\\r"; break;
+            case '\t': out += "\\t"; break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    fmt::format_to(std::back_inserter(out), "\\u{:04x}", static_cast<unsigned char>(c));
+                } else {
+                    out += c;
+                }
+        }
+    }
+    out += '"';
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include "EventArena.hpp" // for the per-shock arena
+#include "ShockConfig.hpp" // for the ranges a shock is drawn from
+
+#include <cstdint> // for uint64_t
+#include <optional> // for std::optional
+#include <random> // for std::mt19937
+#include <string_view> // for std::string_view
+
+// The shock one player has in flight, from building its request until the response, a cancellation
+// or a newer shock ends it. Everything the request needs lives in one pooled arena that is returned
+// when the shock ends. Not thread-safe, the mod only uses it on the main thread.
+class ShockDispatch {
+public:
+    // Identifies one shock, so a late response can't end a newer one
+    using Ticket = uint64_t;
+
+    // What to send, valid until the shock ends
+    struct Request {
+        Ticket ticket;
+        int intensity;
+        int durationMs;
+        std::string_view body; // JSON body for the OpenShock control endpoint
+        std::string_view url;
+    };
+
+    ShockDispatch();
+
+    // Start a shock with a random intensity and duration within the config's ranges. A shock still
+    // in flight is ended first and its ticket goes stale.
+    Request begin(const ShockConfig& config);
+
+    // End the shock with this ticket, returns false if it already ended or a newer one replaced it
+    bool finish(Ticket ticket);
+
+    bool inFlight() const { return m_arena != nullptr; }
+
+    // Duration and intensity of the shock in flight for the pop-up, empty if none is
+    std::string_view summary() const;
+
+private:
+    void release();
+
+    std::mt19937 m_random;
+    Ticket m_ticket = 0;
+    // Declared before the strings that live in it, so they're destroyed first
+    EventArenaPool::Handle m_arena;
+    std::optional<ArenaString> m_body;
+    std::optional<ArenaString> m_url;
+    std::optional<ArenaString> m_summary;
+};
+
+// Append a string to a JSON document as a quoted, escaped JSON string
+void appendJsonString(ArenaString& out, std::string_view value);
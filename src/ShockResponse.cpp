@@ -0,0 +1,71 @@
+#include "ShockResponse.hpp"
+
+#include <string_view> // for std::string_view
+
+namespace {
+    // Shown in place of bytes that aren't valid UTF-8
+    constexpr std::string_view kReplacementCharacter = "\xEF\xBF\xBD";
+
+    // Length of the UTF-8 sequence at the start of `bytes`, 0 if it isn't a valid one
+    std::size_t sequenceLength(std::span<const uint8_t> bytes) {
+        uint8_t lead = bytes[0];
+        std::size_t length;
+        uint32_t codePoint;
+        uint32_t minCodePoint;
+        if (lead < 0x80) {
+            return 1;
+        } else if ((lead & 0xE0) == 0xC0) {
+            length = 2;
+            codePoint = lead & 0x1F;
+            minCodePoint = 0x80;
+        } else if ((lead & 0xF0) == 0xE0) {
+            length = 3;
+            codePoint = lead & 0x0F;
+            minCodePoint = 0x800;
+        } else if ((lead & 0xF8) == 0xF0) {
+            length = 4;
+            codePoint = lead & 0x07;
+            minCodePoint = 0x10000;
+        } else {
+            return 0;
+        }
+
+        if (bytes.size() < length) {
+            return 0;
+        }
+        for (std::size_t i = 1; i < length; i++) {
+            if ((bytes[i] & 0xC0) != 0x80) {
+                return 0;
+            }
+            codePoint = (codePoint << 6) | (bytes[i] & 0x3F);
+        }
+
+        // Overlong encodings, UTF-16 surrogates and anything past U+10FFFF aren't valid either
+        if (codePoint < minCodePoint || (codePoint >= 0xD800 && codePoint <= 0xDFFF) || codePoint > 0x10FFFF) {
+            return 0;
+        }
+        return length;
+    }
+}
+
+std::string responsePopupText(std::span<const uint8_t> body) {
+    if (body.empty()) {
+        return "No response from the server";
+    }
+
+    std::string text;
+    text.reserve(kMaxResponseLength + 3);
+    for (std::size_t i = 0; i < body.size();) {
+        std::size_t length = sequenceLength(body.subspan(i));
+        auto piece = length ? std::string_view(reinterpret_cast<const char*>(body.data() + i), length) : kReplacementCharacter;
+
+        // Stop before the character that doesn't fit, the rest of the body is never read
+        if (text.size() + piece.size() > kMaxResponseLength) {
+            text += "...";
+            break;
+        }
+        text += piece;
+        i += length ? length : 1;
+    }
+    return text;
+}
@@ -0,0 +1,16 @@
+#pragma once
+
+#include <cstddef> // for size_t
+#include <cstdint> // for uint8_t
+#include <span> // for std::span
+#include <string> // for std::string
+
+// Longest server response shown in a pop-up, in bytes
+constexpr std::size_t kMaxResponseLength = 512;
+
+// Largest response body downloaded at all, anything bigger is cancelled while it's coming in
+constexpr std::size_t kMaxResponseBodySize = 64 * 1024;
+
+// Turn a server response body into pop-up text. Only as much of the body as fits in the pop-up is
+// looked at, it's cut at a character boundary and invalid UTF-8 is replaced, so any body is safe to show.
+std::string responsePopupText(std::span<const uint8_t> body);
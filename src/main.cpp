@@ -1,37 +1,66 @@
 #include <Geode/Geode.hpp>
 #include <Geode/modify/PlayerObject.hpp>
 #include <Geode/modify/PlayLayer.hpp> // for pausing and resuming the game
+#include <Geode/modify/LevelEditorLayer.hpp> // for loading the config used in editor playtests
 #include <Geode/utils/web.hpp>
 #include <Geode/loader/Event.hpp>
 #include <Geode/utils/cocos.hpp> // for FLAlertLayer
 #include <Geode/loader/Mod.hpp> // for getting config directory
 #include <Geode/cocos/actions/CCActionManager.h> // include for action pausing
 #include "json.hpp" // Include nlohmann::json for JSON parsing
-
-#include <fstream> // for file reading and writing
+#include "EventArena.hpp" // for per-shock temporary buffers
+#include "Executor.hpp" // for running work off the game thread
+#include "FileService.hpp" // for reading and writing files in the background
+#include "LevelStats.hpp" // for per-level statistics
+#include "ShockConfig.hpp" // for resolving per-level config overrides
+#include "ShockDispatch.hpp" // for the shock in flight
+#include "ShockResponse.hpp" // for showing server responses
+#ifdef OPENSHOCK_DEV_TOOLS
+#include "DeathStorm.hpp" // for the death storm stress run
+#endif
+
+#include <chrono> // for idle timeouts
+#include <optional> // for std::optional
 #include <string> // for std::string
-#include <random> // for random number generation
 
 using json = nlohmann::json;
 using namespace geode::prelude;
 
-class $modify(MyPlayerObject, PlayerObject) {
-    struct Fields {
-        EventListener<web::WebTask> m_listener;
-    };
+// Idle timeout for background workers when settings.json doesn't provide one
+constexpr auto kDefaultIdleTimeout = std::chrono::seconds(60);
 
-    // Function to write the readme.txt file
-    void writeReadme() {
-        auto mod = Mod::get(); // Get the current mod instance
-        auto configDir = mod->getConfigDir(true); // Get the mod's config directory
+$on_mod(Loaded) {
+    // Construct everything the workers touch before the executor. Statics are destroyed in
+    // reverse order, so the executor joins its workers before any of these go away at exit.
+    LevelStatsStore::get();
+    FileService::get();
+    EventArenaPool::get();
 
-        std::ofstream readmeFile(configDir / "readme.txt");
-        if (!readmeFile.is_open()) {
-            log::error("Failed to create readme.txt in the config directory.");
-            return;
-        }
+    // No threads are started until the first level is entered
+    Executor::get();
+}
+
+// Function to get the ID statistics are recorded under for the current level.
+// Local and editor levels all have ID 0 and come back as kUntrackedLevelID.
+static int32_t currentLevelID(PlayLayer* playLayer) {
+    if (!playLayer || !playLayer->m_level) {
+        return kUntrackedLevelID;
+    }
+    return playLayer->m_level->m_levelID.value();
+}
+
+// Config for deaths outside a PlayLayer, such as editor playtests. Those levels have ID 0 like local
+// levels, so it's resolved the same way. Only touched on the main thread.
+static ResolvedShockConfig s_editorShockConfig = { std::nullopt, "Settings are still loading",
+    "Error: Config file is still loading, try again in a moment." };
+
+// Function to write the readme.txt file
+static void writeReadme() {
+    auto mod = Mod::get(); // Get the current mod instance
+    auto configDir = mod->getConfigDir(true); // Get the mod's config directory
 
-        readmeFile << R"(
+    // The file service writes it in the background
+    FileService::get().write(configDir / "readme.txt", R"(
 =======================================================
         OpenShock Mod Configuration Documentation      
 =======================================================
@@ -54,6 +83,8 @@ Supported Fields
 ║ maxIntensity     ║ integer   ║ No       ║ 100              ║ Maximum shock intensity. Must be <= 100.       ║
 ║ customName       ║ string    ║ Yes      ║ N/A              ║ Custom name for the shock control session.     ║
 ║ endpointDomain   ║ string    ║ No       ║ api.openshock.app║ API endpoint domain. Defaults if not provided. ║
+║ levelOverrides   ║ object    ║ No       ║ N/A              ║ Per-level duration/intensity ranges.           ║
+║ idleTimeout      ║ integer   ║ No       ║ 60               ║ Seconds before background work idles down.     ║
 ╚══════════════╩════════╩════════╩══════════════╩═════════════════════════════════════╝
 
 -------------------------------------------------------
@@ -76,6 +107,24 @@ Validation Rules
 4. **Endpoint Domain**:
    - If `endpointDomain` is missing or empty, defaults to `api.openshock.app`.
 
+5. **Level Overrides**:
+   - `levelOverrides` maps a level ID (as a string) to an object that may set
+     `minDuration`, `maxDuration`, `minIntensity` and `maxIntensity`.
+   - Fields left out of an override fall back to the global values.
+   - The merged ranges must follow the same rules as above.
+   - Settings are read when a level starts, so edits apply from the next level.
+   - Local and editor levels all have ID "0", so an override for "0" applies to
+     all of them.
+
+6. **Idle Timeout**:
+   - `idleTimeout` must be >= 0. Background threads shut down after this many
+     seconds outside a level and start again when the next level is entered.
+
+7. **Editor Playtests**:
+   - Deaths while playtesting in the editor shock too, using the settings for
+     level ID "0". They are read when the editor is opened.
+   - These deaths aren't counted in the level statistics.
+
 -------------------------------------------------------
 Example Configuration File
 -------------------------------------------------------
@@ -88,7 +137,11 @@ Example Configuration File
     "minIntensity": 10,
     "maxIntensity": 90,
     "customName": "ShockControl",
-    "endpointDomain": "api.customdomain.com"
+    "endpointDomain": "api.customdomain.com",
+    "levelOverrides": {
+        "128": { "minIntensity": 5, "maxIntensity": 30 },
+        "4284013": { "maxDuration": 3000 }
+    }
 }
 
 -------------------------------------------------------
@@ -101,6 +154,7 @@ Default Behavior
   - `minIntensity`: Defaults to 1.
   - `maxIntensity`: Defaults to 100.
   - `endpointDomain`: Defaults to `api.openshock.app`.
+  - `idleTimeout`: Defaults to 60.
 
 -------------------------------------------------------
 Error Handling
@@ -114,158 +168,251 @@ Error Handling
 -------------------------------------------------------
 
 This document provides all necessary details to configure the OpenShock mod correctly. For further assistance, consult the OpenShock API documentation or contact support.
-)";
-        readmeFile.close();
-    }
+)");
+}
+
+class $modify(MyPlayLayer, PlayLayer) {
+    struct Fields {
+        // Config resolved once at level load, the death path only ever reads this
+        ResolvedShockConfig m_shockConfig;
+        // Set once this attempt's death has been handled, so each death shocks only once
+        bool m_shockFired = false;
+        // Set while the original destroyPlayer runs, the death effect it plays sends the shock
+        bool m_inDestroyPlayer = false;
+        // Player whose shock went out during destroyPlayer, its pop-ups are shown once the call returns
+        PlayerObject* m_popupsPendingFor = nullptr;
+#ifdef OPENSHOCK_DEV_TOOLS
+        // Set while the death storm plays a synthetic death, which is sent to a dry-run transport and not recorded
+        bool m_dryRun = false;
+#endif
+    };
+
+    // Hook into the game's death handling, defined after MyPlayerObject
+    void destroyPlayer(PlayerObject* player, GameObject* object);
+
+#ifdef OPENSHOCK_DEV_TOOLS
+    // Start the death storm requested in settings.json, defined after MyPlayerObject
+    void startDeathStorm();
+#endif
+
+    // Resolve the global settings and this level's override before the level starts
+    bool init(GJGameLevel* level, bool useReplay, bool dontCreateObjects) {
+        if (!PlayLayer::init(level, useReplay, dontCreateObjects)) {
+            return false;
+        }
 
-    // Function to read and validate configuration values from the JSON file
-    json readConfig() {
-        auto mod = Mod::get(); // Get the current mod instance
-        auto configDir = mod->getConfigDir(true); // Get the mod's config directory
+        // Bring the background workers up for the level, they stay alive until it's left
+        Executor::get().enterGameplay();
+
+        // Open the per-level statistics file from the mod's save directory on first use, and make
+        // room for this level now so recording a death never has to grow the table. Attempts and
+        // deaths recorded before the file is open are held by the store until it is.
+        auto statsPath = Mod::get()->getSaveDir() / "level-stats.bin";
+        Executor::get().submit(TaskPriority::Journal, [statsPath] {
+            if (!LevelStatsStore::get().isOpen() && !LevelStatsStore::get().open(statsPath)) {
+                log::error("Failed to open level statistics file at {}", statsPath.string());
+                return;
+            }
+            LevelStatsStore::get().reserveForNewLevel();
+        });
 
         // Write the readme.txt file
         writeReadme();
 
-        std::ifstream configFile(configDir / "settings.json");
-        if (!configFile.is_open()) {
-            log::error("Failed to open settings.json file in config directory");
-            showPopupMessage("Error: Missing config file! Read readme.txt in the mod's config folder.");
-            return {};
-        }
+        // Read the settings in the background, dying before they arrive reports that they're still loading
+        m_fields->m_shockConfig = { std::nullopt, "Settings are still loading",
+            "Error: Config file is still loading, try again in a moment." };
+
+        int32_t levelID = level->m_levelID.value();
+        auto configPath = Mod::get()->getConfigDir(true) / "settings.json";
+        FileService::get().read(configPath, [self = Ref<PlayLayer>(this), levelID](std::optional<std::string> contents) {
+            auto playLayer = static_cast<MyPlayLayer*>(self.data());
+            playLayer->m_fields->m_shockConfig = parseShockConfig(contents, levelID);
+#ifdef OPENSHOCK_DEV_TOOLS
+            playLayer->startDeathStorm();
+#endif
+        });
+        return true;
+    }
 
-        json configJson;
-        try {
-            configFile >> configJson; // Parse the JSON file
-        } catch (const std::exception& e) {
-            log::error("Error parsing JSON file: {}", e.what());
-            showPopupMessage("Error: Invalid config file! Read readme.txt in the mod's config folder.");
-            return {};
-        }
+    // Count every new attempt, including the first one
+    void resetLevel() {
+        m_fields->m_shockFired = false;
+        PlayLayer::resetLevel();
+        LevelStatsStore::get().recordAttempt(currentLevelID(this));
+    }
 
-        // Validate duration and intensity ranges
-        int minDuration = configJson.value("minDuration", 300);
-        int maxDuration = configJson.value("maxDuration", 30000);
-        int minIntensity = configJson.value("minIntensity", 1);
-        int maxIntensity = configJson.value("maxIntensity", 100);
+    // Push the statistics to disk in the background when leaving the level, then let the workers idle down
+    void onQuit() {
+        Executor::get().submit(TaskPriority::Housekeeping, [] {
+            LevelStatsStore::get().flush();
+        });
 
-        if (minDuration < 300 || maxDuration > 30000 || minDuration > maxDuration) {
-            log::error("Invalid duration range in config: minDuration={}, maxDuration={}", minDuration, maxDuration);
-            showPopupMessage("Error: Invalid config file! Read readme.txt in the mod's config folder.");
-            return {};
-        }
+        const auto& resolved = m_fields->m_shockConfig;
+        Executor::get().leaveGameplay(resolved.config ? std::chrono::seconds(resolved.config->idleTimeoutSeconds) : kDefaultIdleTimeout);
+        PlayLayer::onQuit();
+    }
+};
 
-        if (minIntensity < 1 || maxIntensity > 100 || minIntensity > maxIntensity) {
-            log::error("Invalid intensity range in config: minIntensity={}, maxIntensity={}", minIntensity, maxIntensity);
-            showPopupMessage("Error: Invalid config file! Read readme.txt in the mod's config folder.");
-            return {};
+class $modify(MyLevelEditorLayer, LevelEditorLayer) {
+    // Resolve the config for playtesting in the editor whenever it's opened
+    bool init(GJGameLevel* level, bool noUI) {
+        if (!LevelEditorLayer::init(level, noUI)) {
+            return false;
         }
 
-        return configJson;
+        writeReadme();
+        auto configPath = Mod::get()->getConfigDir(true) / "settings.json";
+        FileService::get().read(configPath, [](std::optional<std::string> contents) {
+            s_editorShockConfig = parseShockConfig(contents, kUntrackedLevelID);
+        });
+        return true;
     }
+};
 
-    // Function to generate a random value within a range
-    int generateRandomValue(int min, int max) {
-        std::random_device rd;
-        std::mt19937 gen(rd());
-        std::uniform_int_distribution<> dist(min, max);
-        return dist(gen);
+// Function to get the config a death uses: the level's own, or the editor's outside a level
+static const ResolvedShockConfig& shockConfigFor(PlayLayer* playLayer) {
+    if (!playLayer) {
+        return s_editorShockConfig;
     }
+    return static_cast<MyPlayLayer*>(playLayer)->m_fields->m_shockConfig;
+}
+
+class $modify(MyPlayerObject, PlayerObject) {
+    struct Fields {
+        EventListener<web::WebTask> m_listener;
+        // The shock in flight, its request and pop-up text live in a pooled arena until it completes
+        ShockDispatch m_dispatch;
+    };
 
-    // Hook into the player's death effect
+    // Hook into the player's death effect. Inside PlayLayer::destroyPlayer the game has already decided the
+    // player dies when it plays this, so the shock goes out before the effect is built and the pause, stats
+    // and pop-ups follow once destroyPlayer returns. Deaths outside destroyPlayer are handled here in full.
     void playDeathEffect() {
+        auto playLayer = static_cast<MyPlayLayer*>(PlayLayer::get());
+        if (playLayer && playLayer->m_fields->m_inDestroyPlayer) {
+            if (!playLayer->m_fields->m_shockFired) {
+                playLayer->m_fields->m_shockFired = true;
+                playLayer->m_fields->m_popupsPendingFor = this;
+                sendPostRequest();
+            }
+            PlayerObject::playDeathEffect();
+            return;
+        }
+
         // Call the original death effect function to keep the default behavior
         PlayerObject::playDeathEffect();
 
+        // Outside a level, e.g. an editor playtest, every death effect is a death
+        bool dryRun = false;
+        if (playLayer) {
+            if (playLayer->m_fields->m_shockFired) {
+                return; // This death was already handled
+            }
+            playLayer->m_fields->m_shockFired = true;
+#ifdef OPENSHOCK_DEV_TOOLS
+            dryRun = playLayer->m_fields->m_dryRun;
+#endif
+        }
+        sendPostRequest(dryRun);
+        showShockPopups(dryRun);
+    }
+
+    // Function to record the death, pause the game and show what was sent. Synthetic
+    // deaths from a dry run go through the same steps but stay out of the statistics.
+    void showShockPopups(bool dryRun = false) {
+        // Record where the player died, deaths outside a level aren't tracked
+        auto playLayer = PlayLayer::get();
+        if (playLayer && !dryRun) {
+            LevelStatsStore::get().recordDeath(currentLevelID(playLayer), playLayer->getCurrentPercentInt());
+        }
+
         // Immediately pause the game and show "Shocking..."
         pauseGame();
         showPopupMessage("Shocking...");
 
-        // Execute the custom web request after showing the message
-        sendPostRequest();
-    }
-
-    // Function to send a POST request with JSON data
-    void sendPostRequest() {
-        // Read the configuration from the JSON file
-        json config = readConfig();
-        if (config.empty()) {
-            return; // Exit if the configuration couldn't be read or is invalid
+        const auto& resolved = shockConfigFor(playLayer);
+        if (!resolved.config) {
+            log::error("{}", resolved.logMessage);
+            showPopupMessage(resolved.popupMessage.c_str());
+            return;
         }
 
-        // Extract the min and max values for random generation
-        int minDuration = config.value("minDuration", 300);
-        int maxDuration = config.value("maxDuration", 30000);
-        int minIntensity = config.value("minIntensity", 1);
-        int maxIntensity = config.value("maxIntensity", 100);
-        auto shockerID = config.value("shockerID", "");
-        auto openShockToken = config.value("OpenShockToken", "");
-        auto customName = config.value("customName", "");
-
-        // Get the endpoint domain, default to api.openshock.app if missing or empty
-        std::string endpointDomain = config.value("endpointDomain", "api.openshock.app");
-        if (endpointDomain.empty()) {
-            endpointDomain = "api.openshock.app";
+        // Show the duration and intensity in a pop-up message
+        if (m_fields->m_dispatch.inFlight()) {
+            showPopupMessage(std::string(m_fields->m_dispatch.summary()).c_str());
         }
+    }
 
-        if (shockerID.empty() || openShockToken.empty() || customName.empty()) {
-            log::error("Missing required fields in JSON configuration");
-            showPopupMessage("Error: Missing required fields in config file! Read readme.txt in the mod's config folder.");
-            return;
+    // Function to send a POST request with JSON data, errors are reported by showShockPopups.
+    // A dry run builds the same request but completes it locally instead of sending it.
+    void sendPostRequest(bool dryRun = false) {
+        // Use the config resolved when the level (or the editor) was loaded
+        auto playLayer = PlayLayer::get();
+        const auto& resolved = shockConfigFor(playLayer);
+        if (!resolved.config) {
+            return; // Exit if the configuration couldn't be read or is invalid
         }
+        const auto& config = *resolved.config;
 
-        // Generate random intensity and duration within the valid ranges
-        int randomIntensity = generateRandomValue(minIntensity, maxIntensity);
-        int randomDurationMs = generateRandomValue(minDuration, maxDuration);
+        // Pick the values and build the request, ending any shock this player still has in flight
+        auto shock = m_fields->m_dispatch.begin(config);
+        auto ticket = shock.ticket;
 
         // Bind the listener to handle the response
-        m_fields->m_listener.bind([this](web::WebTask::Event* e) {
+        m_fields->m_listener.bind([this, ticket](web::WebTask::Event* e) {
             if (web::WebResponse* res = e->getValue()) {
-                // Get the server response as a string
-                std::string response = res->string().unwrapOr("No response from the server");
+                // Only the start of the body is decoded, so a huge or malformed one can't stall the pop-up
+                std::string response = responsePopupText(res->data());
 
                 // Show the response in a pop-up message
-                showPopupMessage(response);
+                showPopupMessage(response.c_str());
+                m_fields->m_dispatch.finish(ticket);
 
             } else if (web::WebProgress* p = e->getProgress()) {
+                // No real response is anywhere near this big, stop downloading it instead of buffering it
+                if (p->downloadTotal() > kMaxResponseBodySize || p->downloaded() > kMaxResponseBodySize) {
+                    log::warn("Response is larger than {} bytes, cancelling the request", kMaxResponseBodySize);
+                    m_fields->m_listener.getFilter().cancel();
+                    return;
+                }
+
                 // Log the progress of the request if it's still in progress
                 log::info("Request in progress... Download progress: {}%", p->downloadProgress().value_or(0.f) * 100);
             } else if (e->isCancelled()) {
                 // Show a cancellation message in the pop-up
                 showPopupMessage("Request was cancelled.");
+                m_fields->m_dispatch.finish(ticket);
             }
         });
 
         // Create the web request object
         auto req = web::WebRequest();
 
-        // Set the request body as JSON (as a string), using the generated values
-        json requestBody = {
-            { "shocks", {{
-                { "id", shockerID },
-                { "type", "Shock" },
-                { "intensity", randomIntensity },
-                { "duration", randomDurationMs },
-                { "exclusive", true }
-            }}},
-            { "customName", customName }
-        };
-
         // Add the JSON body to the request
-        req.bodyString(requestBody.dump());
+        req.bodyString(shock.body);
 
         // Set the content type header to application/json
         req.header("Content-Type", "application/json");
         req.header("accept", "application/json");
 
         // Add the OpenShockToken header
-        req.header("OpenShockToken", openShockToken);
-
-        // Construct the full URL with the endpoint domain
-        std::string url = "https://" + endpointDomain + "/2/shockers/control";
-        m_fields->m_listener.setFilter(req.post(url));
+        req.header("OpenShockToken", config.openShockToken);
+
+        if (dryRun) {
+            // Loopback transport: complete on the next frame without touching the network, unless a newer shock replaced this one
+            queueInMainThread([self = Ref<PlayerObject>(this), ticket] {
+                auto player = static_cast<MyPlayerObject*>(self.data());
+                if (player->m_fields->m_dispatch.finish(ticket)) {
+                    player->showPopupMessage("Dry run, no shock was sent.");
+                }
+            });
+            return;
+        }
+        m_fields->m_listener.setFilter(req.post(shock.url));
 
-        // Show the duration and intensity in a pop-up message
-        showPopupMessage("Duration: " + std::to_string(randomDurationMs / 1000) + "s" + "     " + "Intensity: " + std::to_string(randomIntensity));
+        // Add the shock to the level's statistics
+        LevelStatsStore::get().recordShock(currentLevelID(playLayer), shock.intensity, shock.durationMs);
     }
 
     // Function to pause the game
@@ -282,10 +429,58 @@ This document provides all necessary details to configure the OpenShock mod corr
     }
 
     // Function to show a pop-up message
-    void showPopupMessage(const std::string& message) {
-        auto alertLayer = FLAlertLayer::create(nullptr, "Message", message.c_str(), "Continue", nullptr);
+    void showPopupMessage(const char* message) {
+        auto alertLayer = FLAlertLayer::create(nullptr, "Message", message, "Continue", nullptr);
         alertLayer->onBtn1(this); // Set a tag for the pop-up layer
         alertLayer->show();
     }
 
 };
+
+void MyPlayLayer::destroyPlayer(PlayerObject* player, GameObject* object) {
+    // The original decides whether the player dies (noclip, the anticheat spike while loading, ...),
+    // and once it has, the death effect it plays sends the shock
+    bool wasDead = player->m_isDead;
+    m_fields->m_inDestroyPlayer = true;
+    PlayLayer::destroyPlayer(player, object);
+    m_fields->m_inDestroyPlayer = false;
+
+    if (auto shocked = static_cast<MyPlayerObject*>(m_fields->m_popupsPendingFor)) {
+        // Pause, record and show what was sent now that the game's own death handling is done
+        m_fields->m_popupsPendingFor = nullptr;
+        shocked->showShockPopups();
+    } else if (!wasDead && player->m_isDead && !m_fields->m_shockFired) {
+        // The player died without a death effect, so nothing has been sent yet
+        m_fields->m_shockFired = true;
+        auto myPlayer = static_cast<MyPlayerObject*>(player);
+        myPlayer->sendPostRequest();
+        myPlayer->showShockPopups();
+    }
+}
+
+#ifdef OPENSHOCK_DEV_TOOLS
+void MyPlayLayer::startDeathStorm() {
+    const auto& resolved = m_fields->m_shockConfig;
+    if (!resolved.config || resolved.config->devStormCount <= 0) {
+        return;
+    }
+
+    // Each synthetic death plays the death effect through the playDeathEffect hook, with a dry-run transport.
+    // destroyPlayer isn't used because it ends the attempt, and the paused pop-ups keep the player from respawning.
+    DeathStorm::start(resolved.config->devStormCount, resolved.config->devStormIntervalMs / 1000.f, [] {
+        auto playLayer = static_cast<MyPlayLayer*>(PlayLayer::get());
+        if (!playLayer || !playLayer->m_player1) {
+            return false;
+        }
+
+        // A synthetic death must not use up, or be blocked by, the shock of the real attempt
+        bool shockFired = playLayer->m_fields->m_shockFired;
+        playLayer->m_fields->m_shockFired = false;
+        playLayer->m_fields->m_dryRun = true;
+        playLayer->m_player1->playDeathEffect();
+        playLayer->m_fields->m_dryRun = false;
+        playLayer->m_fields->m_shockFired = shockFired;
+        return true;
+    });
+}
+#endif
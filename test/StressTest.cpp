@@ -0,0 +1,312 @@
+// Headless stress test for the mod's background pipeline, meant to run under ThreadSanitizer or
+// AddressSanitizer. It hammers the executor, config hot-reload through the file service, the mod's
+// ShockDispatch with responses racing cancellations and newer shocks, stats updates with table
+// growth, and shuts the executor down while all of that is still going. Prints throughput and exits non-zero if an
+// invariant breaks; the sanitizers report races and memory errors on their own.
+//
+// Usage: openshock-stress [seconds]
+
+#include <Geode/loader/Loader.hpp> // for the test's main-thread queue
+
+#include "EventArena.hpp"
+#include "Executor.hpp"
+#include "FileService.hpp"
+#include "LevelStats.hpp"
+#include "ShockConfig.hpp"
+#include "ShockDispatch.hpp"
+
+#include <fmt/format.h> // for fmt::format
+
+#include <atomic> // for std::atomic
+#include <chrono> // for timing
+#include <cstdlib> // for std::atoi
+#include <fstream> // for std::ofstream
+#include <random> // for random number generation
+#include <thread> // for std::thread
+#include <utility> // for std::exchange
+#include <vector> // for std::vector
+
+#ifdef __linux__
+#include <sys/resource.h> // for setpriority
+#include <sys/syscall.h> // for SYS_gettid
+#include <unistd.h> // for syscall
+#endif
+
+using namespace std::chrono_literals;
+
+namespace {
+    struct Counters {
+        std::atomic<uint64_t> tasksSubmitted = 0;
+        std::atomic<uint64_t> tasksRejected = 0;
+        std::atomic<uint64_t> tasksRun = 0;
+        std::atomic<uint64_t> configWrites = 0;
+        std::atomic<uint64_t> configReloads = 0;
+        std::atomic<uint64_t> dispatches = 0;
+        std::atomic<uint64_t> completions = 0;
+        std::atomic<uint64_t> cancellations = 0;
+        std::atomic<uint64_t> superseded = 0;
+        std::atomic<uint64_t> staleResponses = 0;
+        std::atomic<uint64_t> deathsRecorded = 0;
+        std::atomic<uint64_t> levelsLoaded = 0;
+        std::atomic<uint64_t> failures = 0;
+    };
+
+    Counters s_counters;
+
+    void fail(const std::string& message) {
+        fmt::print(stderr, "FAIL: {}\n", message);
+        s_counters.failures++;
+    }
+
+    std::string settingsFor(int minIntensity, int maxIntensity) {
+        return fmt::format(R"({{"shockerID":"stress","OpenShockToken":"token","customName":"Stress",)"
+            R"("minIntensity":{},"maxIntensity":{},"minDuration":300,"maxDuration":1000}})", minIntensity, maxIntensity);
+    }
+
+    // Run the hammering threads at the workers' priority, otherwise on a small machine they starve the
+    // executor completely and the run measures nothing
+    void matchWorkerPriority() {
+#ifdef __linux__
+        setpriority(PRIO_PROCESS, static_cast<id_t>(syscall(SYS_gettid)), 10);
+#endif
+    }
+
+    std::thread::id s_mainThread;
+
+    // Stands in for a Geode Ref<T> in a callback: its reference count isn't thread-safe, so copying or
+    // releasing one anywhere but the main thread is a bug even though nothing crashes here
+    struct MainThreadRef {
+        bool held = true;
+
+        MainThreadRef() = default;
+        MainThreadRef(const MainThreadRef&) { checkThread("copied"); }
+        MainThreadRef(MainThreadRef&& other) noexcept : held(std::exchange(other.held, false)) {}
+        ~MainThreadRef() {
+            if (held) {
+                checkThread("released");
+            }
+        }
+
+        static void checkThread(const char* what) {
+            if (std::this_thread::get_id() != s_mainThread) {
+                fail(fmt::format("a callback's Ref was {} off the main thread", what));
+            }
+        }
+    };
+
+    // One death: start a shock like MyPlayLayer::sendPostRequest, record it, then let the response
+    // come back through a worker and the main-thread queue while the main thread may cancel it or
+    // replace it with the next shock first
+    void sendShock(ShockDispatch& dispatch, const ShockConfig& config, int levelID, std::mt19937& rng) {
+        if (dispatch.inFlight()) {
+            s_counters.superseded++;
+        }
+        auto shock = dispatch.begin(config);
+        s_counters.dispatches++;
+
+        if (shock.intensity < config.minIntensity || shock.intensity > config.maxIntensity) {
+            fail("intensity outside the config's range");
+        }
+        if (shock.durationMs < config.minDuration || shock.durationMs > config.maxDuration) {
+            fail("duration outside the config's range");
+        }
+        auto fields = fmt::format(R"("intensity":{},"duration":{})", shock.intensity, shock.durationMs);
+        if (shock.body.find(R"({"shocks":[{"id":"stress")") != 0 || shock.body.find(fields) == std::string_view::npos) {
+            fail(fmt::format("request body doesn't match the shock: {}", shock.body));
+        }
+
+        LevelStatsStore::get().recordDeath(levelID, int(rng() % 101));
+        LevelStatsStore::get().recordShock(levelID, shock.intensity, shock.durationMs);
+        s_counters.deathsRecorded++;
+
+        auto ticket = shock.ticket;
+        bool queued = Executor::get().submit(TaskPriority::Dispatch, [&dispatch, ticket] {
+            geode::queueInMainThread([&dispatch, ticket] {
+                if (dispatch.finish(ticket)) {
+                    s_counters.completions++;
+                } else {
+                    s_counters.staleResponses++;
+                }
+            });
+        });
+        if (!queued || rng() % 4 == 0) {
+            if (dispatch.finish(ticket)) {
+                s_counters.cancellations++;
+            } else {
+                fail("couldn't cancel the shock that was just started");
+            }
+        }
+    }
+}
+
+int main(int argc, char** argv) {
+    s_mainThread = std::this_thread::get_id();
+    auto duration = std::chrono::seconds(argc > 1 ? std::atoi(argv[1]) : 5);
+
+    auto dir = std::filesystem::temp_directory_path() / fmt::format("openshock-stress-{}", std::random_device{}());
+    std::filesystem::create_directories(dir);
+    auto settingsPath = dir / "settings.json";
+    auto statsPath = dir / "level-stats.bin";
+
+    // Same construction order as the mod, so the executor is destroyed first
+    auto& stats = LevelStatsStore::get();
+    auto& files = FileService::get();
+    EventArenaPool::get();
+    auto& executor = Executor::get();
+    executor.enterGameplay();
+
+    // A file that isn't a stats table is moved aside, not overwritten
+    std::ofstream(statsPath, std::ios::binary) << "not a stats table";
+    auto badStatsPath = statsPath;
+    badStatsPath += ".bad";
+
+    // Updates made before the store is open, like a first attempt racing the open at level load
+    constexpr int32_t kEarlyLevelID = -1; // never used by the level loader
+    stats.recordAttempt(kEarlyLevelID);
+    stats.recordDeath(kEarlyLevelID, 50);
+    if (!stats.open(statsPath)) {
+        fail("couldn't open the stats file");
+        return 1;
+    }
+    if (!std::filesystem::exists(badStatsPath)) {
+        fail("an invalid stats file wasn't moved aside");
+    }
+    files.write(settingsPath, settingsFor(10, 20));
+
+    // Resolved config, swapped by hot-reloads on the main thread like the mod's PlayLayer fields
+    ResolvedShockConfig snapshot;
+    ShockDispatch dispatch;
+    std::mt19937 rng(100);
+    std::atomic<int> loadedLevels = 0;
+    std::atomic<bool> stopping = false;
+    std::atomic<bool> executorDown = false;
+    std::vector<std::thread> threads;
+
+    // Producers: plain enqueue pressure on every priority class
+    for (int t = 0; t < 2; t++) {
+        threads.emplace_back([&, t] {
+            matchWorkerPriority();
+            std::mt19937 rng(t);
+            while (!stopping) {
+                auto priority = static_cast<TaskPriority>(rng() % 3);
+                if (executor.submit(priority, [] { s_counters.tasksRun++; })) {
+                    s_counters.tasksSubmitted++;
+                } else {
+                    s_counters.tasksRejected++;
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+
+    // Config writer: rewrites settings.json with new ranges, and now and then with garbage
+    threads.emplace_back([&] {
+        std::mt19937 rng(42);
+        while (!stopping && !executorDown) {
+            int low = 1 + int(rng() % 50);
+            files.write(settingsPath, rng() % 10 == 0 ? std::string("{ not json") : settingsFor(low, low + int(rng() % 50)));
+            s_counters.configWrites++;
+            std::this_thread::sleep_for(200us);
+        }
+    });
+
+    // Level loader: makes room for a new level before anything records it, like PlayLayer::init
+    threads.emplace_back([&] {
+        while (!stopping && !executorDown) {
+            executor.submit(TaskPriority::Journal, [&] {
+                stats.reserveForNewLevel();
+                loadedLevels++;
+                s_counters.levelsLoaded++;
+            });
+            std::this_thread::sleep_for(500us);
+        }
+    });
+
+    // The test's main thread: hot-reloads the config, sends shocks and runs main-thread callbacks
+    auto start = std::chrono::steady_clock::now();
+    auto shutdownAt = start + duration * 3 / 4;
+    bool shutDown = false;
+    std::atomic<bool> reloadPending = false;
+    while (std::chrono::steady_clock::now() - start < duration) {
+        if (!shutDown && !reloadPending.exchange(true)) {
+            files.read(settingsPath, [&, ref = MainThreadRef()](std::optional<std::string> contents) {
+                snapshot = parseShockConfig(contents, 1);
+                s_counters.configReloads++;
+                reloadPending = false;
+            });
+        }
+        // Like the game, only the level that was loaded last gets new records. Now and then the next
+        // death comes before the last shock's response
+        int levelID = loadedLevels;
+        if (snapshot.config && levelID != 0 && (!dispatch.inFlight() || rng() % 8 == 0)) {
+            sendShock(dispatch, *snapshot.config, levelID, rng);
+        }
+        openshock::test::drainMainThread();
+
+        // Shut the executor down while everything else is still hammering it
+        if (!shutDown && std::chrono::steady_clock::now() >= shutdownAt) {
+            executorDown = true;
+            executor.shutdown();
+            shutDown = true;
+        }
+        std::this_thread::sleep_for(100us);
+    }
+
+    stopping = true;
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    executor.shutdown();
+    openshock::test::drainMainThread();
+    auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    // Every shock must have ended exactly once, by its response, a cancellation or the next shock
+    uint64_t ended = s_counters.completions + s_counters.cancellations + s_counters.superseded + (dispatch.inFlight() ? 1 : 0);
+    if (ended != s_counters.dispatches) {
+        fail(fmt::format("{} dispatches but {} completions, {} cancellations and {} superseded",
+            s_counters.dispatches.load(), s_counters.completions.load(), s_counters.cancellations.load(), s_counters.superseded.load()));
+    }
+
+    // Stats survive a reopen and hold every recorded death
+    stats.close();
+    if (!stats.open(statsPath)) {
+        fail("couldn't reopen the stats file");
+    }
+    uint64_t deaths = 0;
+    for (int levelID = 1; levelID <= loadedLevels; levelID++) {
+        if (auto record = stats.find(levelID)) {
+            deaths += record->deaths;
+        }
+    }
+    auto early = stats.find(kEarlyLevelID);
+    if (!early || early->attempts != 1 || early->deaths != 1) {
+        fail("updates made before the stats file was open were lost");
+    }
+    if (deaths != s_counters.deathsRecorded) {
+        fail(fmt::format("{} deaths recorded but {} found after reopening", s_counters.deathsRecorded.load(), deaths));
+    }
+    if (executor.failedTaskCount() != 0) {
+        fail(fmt::format("{} background tasks failed", executor.failedTaskCount()));
+    }
+    stats.close();
+
+    std::error_code ec;
+    std::filesystem::remove_all(dir, ec);
+
+    auto rate = [elapsed](const std::atomic<uint64_t>& count) { return double(count) / elapsed; };
+    fmt::print("stress run: {:.1f}s\n", elapsed);
+    fmt::print("  executor tasks   {:>10} run, {:>12.0f}/s ({} rejected)\n", s_counters.tasksRun.load(), rate(s_counters.tasksRun), s_counters.tasksRejected.load());
+    fmt::print("  shock dispatches {:>10},     {:>12.0f}/s ({} completed, {} cancelled, {} superseded, {} stale responses)\n",
+        s_counters.dispatches.load(), rate(s_counters.dispatches), s_counters.completions.load(), s_counters.cancellations.load(),
+        s_counters.superseded.load(), s_counters.staleResponses.load());
+    fmt::print("  config writes    {:>10},     {:>12.0f}/s\n", s_counters.configWrites.load(), rate(s_counters.configWrites));
+    fmt::print("  config reloads   {:>10},     {:>12.0f}/s\n", s_counters.configReloads.load(), rate(s_counters.configReloads));
+    fmt::print("  levels loaded    {:>10},     {:>12.0f}/s\n", s_counters.levelsLoaded.load(), rate(s_counters.levelsLoaded));
+    fmt::print("  deaths recorded  {:>10},     {:>12.0f}/s\n", s_counters.deathsRecorded.load(), rate(s_counters.deathsRecorded));
+
+    if (s_counters.failures != 0) {
+        fmt::print(stderr, "{} invariant failures\n", s_counters.failures.load());
+        return 1;
+    }
+    return 0;
+}
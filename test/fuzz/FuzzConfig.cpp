@@ -0,0 +1,41 @@
+// Fuzz target for parsing settings.json: any input must either resolve to a config that passes every
+// validation rule or be rejected with a message, without crashing, hanging or blowing up memory.
+
+#include "ShockConfig.hpp"
+
+#include <cstdint> // for uint8_t
+#include <cstdlib> // for std::abort
+#include <cstdio> // for std::fprintf
+#include <string> // for std::string
+
+namespace {
+    // Level the fuzzer's overrides apply to, the seed corpus uses the same ID
+    constexpr int32_t kFuzzLevelID = 128;
+
+    void check(bool condition, const char* what) {
+        if (!condition) {
+            std::fprintf(stderr, "invariant broken: %s\n", what);
+            std::abort();
+        }
+    }
+}
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, std::size_t size) {
+    std::string contents(reinterpret_cast<const char*>(data), size);
+    auto resolved = parseShockConfig(contents, kFuzzLevelID);
+
+    if (!resolved.config) {
+        check(!resolved.logMessage.empty() && !resolved.popupMessage.empty(), "rejected config without a message");
+        return 0;
+    }
+
+    const auto& config = *resolved.config;
+    check(config.minDuration >= 300 && config.maxDuration <= 30000 && config.minDuration <= config.maxDuration, "duration range");
+    check(config.minIntensity >= 1 && config.maxIntensity <= 100 && config.minIntensity <= config.maxIntensity, "intensity range");
+    check(config.idleTimeoutSeconds >= 0, "idle timeout");
+    check(config.devStormCount >= 0 && config.devStormCount <= 10000, "death storm count");
+    check(config.devStormIntervalMs >= 0 && config.devStormIntervalMs <= 60000, "death storm interval");
+    check(!config.shockerID.empty() && !config.openShockToken.empty() && !config.customName.empty(), "required fields");
+    check(!config.endpointDomain.empty(), "endpoint domain");
+    return 0;
+}
@@ -0,0 +1,142 @@
+// Stand-in for libFuzzer's main on compilers without -fsanitize=fuzzer. It runs every input in the
+// given files and directories, then random mutations of them, under the same limits libFuzzer takes:
+//
+//   fuzz-target [-runs=N] [-seed=N] [-timeout=seconds] [-rss_limit_mb=N] <file or directory>...
+//
+// Any crash or broken invariant aborts, which is what the sanitizers and ctest look for.
+
+#include <algorithm> // for std::min
+#include <csignal> // for SIGALRM
+#include <cstdint> // for uint8_t
+#include <cstdio> // for std::fprintf
+#include <cstdlib> // for std::abort
+#include <cstring> // for std::strncmp
+#include <filesystem> // for directory iteration
+#include <fstream> // for std::ifstream
+#include <iterator> // for std::istreambuf_iterator
+#include <random> // for std::mt19937
+#include <string> // for std::string
+#include <vector> // for std::vector
+
+#include <sys/resource.h> // for getrusage
+#include <unistd.h> // for alarm
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, std::size_t size);
+
+namespace {
+    using Input = std::vector<uint8_t>;
+
+    // Largest mutated input, well past the parsers' own limits
+    constexpr std::size_t kMaxMutatedSize = 128 * 1024;
+
+    unsigned s_timeoutSeconds = 0;
+    long s_rssLimitMb = 0;
+
+    void onTimeout(int) {
+        static const char message[] = "input timed out\n";
+        write(STDERR_FILENO, message, sizeof(message) - 1);
+        std::abort();
+    }
+
+    void runOne(const Input& input) {
+        alarm(s_timeoutSeconds);
+        LLVMFuzzerTestOneInput(input.data(), input.size());
+        alarm(0);
+
+        rusage usage{};
+        getrusage(RUSAGE_SELF, &usage);
+        if (s_rssLimitMb > 0 && usage.ru_maxrss / 1024 > s_rssLimitMb) {
+            std::fprintf(stderr, "rss limit exceeded: %ld MB\n", usage.ru_maxrss / 1024);
+            std::abort();
+        }
+    }
+
+    void addInput(const std::filesystem::path& path, std::vector<Input>& inputs) {
+        std::ifstream file(path, std::ios::binary);
+        inputs.emplace_back(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    }
+
+    // A few cheap mutations in the spirit of libFuzzer's: flip, overwrite, insert, erase, repeat, splice
+    Input mutate(const std::vector<Input>& inputs, std::mt19937& rng) {
+        Input input = inputs[rng() % inputs.size()];
+        for (int count = 1 + int(rng() % 4); count > 0; count--) {
+            std::size_t at = input.empty() ? 0 : rng() % input.size();
+            switch (rng() % 6) {
+                case 0:
+                    if (!input.empty()) input[at] ^= uint8_t(1u << (rng() % 8));
+                    break;
+                case 1:
+                    if (!input.empty()) input[at] = uint8_t(rng());
+                    break;
+                case 2:
+                    input.insert(input.begin() + at, uint8_t(rng()));
+                    break;
+                case 3:
+                    if (!input.empty()) input.erase(input.begin() + at, input.begin() + std::min(input.size(), at + 1 + rng() % 8));
+                    break;
+                case 4: {
+                    // Repeat a chunk, which builds deep nesting and long numbers
+                    std::size_t length = std::min<std::size_t>(input.size() - at, 1 + rng() % 16);
+                    Input chunk(input.begin() + at, input.begin() + at + length);
+                    for (int n = int(rng() % 64); n > 0 && input.size() + chunk.size() <= kMaxMutatedSize; n--) {
+                        input.insert(input.begin() + at, chunk.begin(), chunk.end());
+                    }
+                    break;
+                }
+                default: {
+                    const Input& other = inputs[rng() % inputs.size()];
+                    if (!other.empty()) {
+                        std::size_t from = rng() % other.size();
+                        input.insert(input.begin() + at, other.begin() + from, other.begin() + std::min(other.size(), from + 1 + rng() % 32));
+                    }
+                }
+            }
+        }
+        if (input.size() > kMaxMutatedSize) {
+            input.resize(kMaxMutatedSize);
+        }
+        return input;
+    }
+}
+
+int main(int argc, char** argv) {
+    long runs = 0;
+    unsigned seed = 1;
+    std::vector<Input> inputs;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg.rfind("-runs=", 0) == 0) {
+            runs = std::stol(arg.substr(6));
+        } else if (arg.rfind("-seed=", 0) == 0) {
+            seed = unsigned(std::stoul(arg.substr(6)));
+        } else if (arg.rfind("-timeout=", 0) == 0) {
+            s_timeoutSeconds = unsigned(std::stoul(arg.substr(9)));
+        } else if (arg.rfind("-rss_limit_mb=", 0) == 0) {
+            s_rssLimitMb = std::stol(arg.substr(14));
+        } else if (arg[0] == '-') {
+            std::fprintf(stderr, "ignoring unsupported flag %s\n", arg.c_str());
+        } else if (std::filesystem::is_directory(arg)) {
+            for (const auto& entry : std::filesystem::directory_iterator(arg)) {
+                if (entry.is_regular_file()) {
+                    addInput(entry.path(), inputs);
+                }
+            }
+        } else {
+            addInput(arg, inputs);
+        }
+    }
+    if (inputs.empty()) {
+        inputs.emplace_back();
+    }
+    std::signal(SIGALRM, onTimeout);
+
+    for (const auto& input : inputs) {
+        runOne(input);
+    }
+    std::mt19937 rng(seed);
+    for (long run = 0; run < runs; run++) {
+        runOne(mutate(inputs, rng));
+    }
+    std::fprintf(stderr, "ran %zu inputs and %ld mutations\n", inputs.size(), runs);
+    return 0;
+}
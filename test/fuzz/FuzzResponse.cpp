@@ -0,0 +1,58 @@
+// Fuzz target for turning a server response into pop-up text: the text must always be valid UTF-8,
+// fit in the pop-up, and match the body exactly whenever the body is short, valid and non-empty.
+
+#include "ShockResponse.hpp"
+
+#include <cstdint> // for uint8_t
+#include <cstdlib> // for std::abort
+#include <cstdio> // for std::fprintf
+#include <string_view> // for std::string_view
+
+namespace {
+    void check(bool condition, const char* what) {
+        if (!condition) {
+            std::fprintf(stderr, "invariant broken: %s\n", what);
+            std::abort();
+        }
+    }
+
+    // Independent UTF-8 check: shortest form, no surrogates, nothing past U+10FFFF
+    bool isValidUtf8(std::string_view text) {
+        for (std::size_t i = 0; i < text.size();) {
+            auto lead = static_cast<uint8_t>(text[i]);
+            std::size_t length = lead < 0x80 ? 1 : lead >= 0xC2 && lead <= 0xDF ? 2 : lead >= 0xE0 && lead <= 0xEF ? 3 : lead >= 0xF0 && lead <= 0xF4 ? 4 : 0;
+            if (length == 0 || i + length > text.size()) {
+                return false;
+            }
+
+            uint32_t codePoint = length == 1 ? lead : lead & (0x7F >> length);
+            for (std::size_t n = 1; n < length; n++) {
+                auto next = static_cast<uint8_t>(text[i + n]);
+                if ((next & 0xC0) != 0x80) {
+                    return false;
+                }
+                codePoint = (codePoint << 6) | (next & 0x3F);
+            }
+            if ((length == 3 && codePoint < 0x800) || (length == 4 && codePoint < 0x10000)
+                || (codePoint >= 0xD800 && codePoint <= 0xDFFF) || codePoint > 0x10FFFF) {
+                return false;
+            }
+            i += length;
+        }
+        return true;
+    }
+}
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, std::size_t size) {
+    auto text = responsePopupText({ data, size });
+
+    check(!text.empty(), "empty pop-up text");
+    check(text.size() <= kMaxResponseLength + 3, "pop-up text too long");
+    check(isValidUtf8(text), "pop-up text isn't valid UTF-8");
+
+    std::string_view body(reinterpret_cast<const char*>(data), size);
+    if (size != 0 && size <= kMaxResponseLength && isValidUtf8(body)) {
+        check(text == body, "short valid body was changed");
+    }
+    return 0;
+}
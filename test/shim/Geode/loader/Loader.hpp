@@ -0,0 +1,22 @@
+#pragma once
+
+// Stand-in for Geode's loader so the Geode-independent sources build for tests
+
+#include "Log.hpp"
+
+#include <cstddef> // for size_t
+#include <functional> // for std::function
+
+namespace geode {
+    // Queue a function for the test's main thread, which runs it from drainMainThread()
+    void queueInMainThread(std::function<void()> func);
+
+    namespace prelude {
+        using namespace ::geode;
+    }
+}
+
+namespace openshock::test {
+    // Run everything queued for the main thread so far, returns how many functions ran
+    std::size_t drainMainThread();
+}
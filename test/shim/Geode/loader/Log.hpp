@@ -0,0 +1,25 @@
+#pragma once
+
+// Stand-in for Geode's logger so the Geode-independent sources build for tests
+
+#include <fmt/format.h> // for fmt::format_string
+
+#include <cstdio> // for stderr
+#include <utility> // for std::forward
+
+namespace geode::log {
+    template <typename... Args>
+    void info(fmt::format_string<Args...> format, Args&&... args) {
+        fmt::print(stderr, "[info] {}\n", fmt::format(format, std::forward<Args>(args)...));
+    }
+
+    template <typename... Args>
+    void warn(fmt::format_string<Args...> format, Args&&... args) {
+        fmt::print(stderr, "[warn] {}\n", fmt::format(format, std::forward<Args>(args)...));
+    }
+
+    template <typename... Args>
+    void error(fmt::format_string<Args...> format, Args&&... args) {
+        fmt::print(stderr, "[error] {}\n", fmt::format(format, std::forward<Args>(args)...));
+    }
+}
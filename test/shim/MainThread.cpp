@@ -0,0 +1,27 @@
+#include <Geode/loader/Loader.hpp>
+
+#include <mutex> // for std::mutex
+#include <vector> // for std::vector
+
+namespace {
+    std::mutex s_mutex;
+    std::vector<std::function<void()>> s_queue;
+}
+
+void geode::queueInMainThread(std::function<void()> func) {
+    std::lock_guard lock(s_mutex);
+    s_queue.push_back(std::move(func));
+}
+
+std::size_t openshock::test::drainMainThread() {
+    std::vector<std::function<void()>> queue;
+    {
+        std::lock_guard lock(s_mutex);
+        queue.swap(s_queue);
+    }
+
+    for (auto& func : queue) {
+        func();
+    }
+    return queue.size();
+}